@@ -0,0 +1,18 @@
+#!/usr/bin/env bash
+# Client Slate / UI time of the HUD overlay with and without its invalidation box, headless.
+#
+#   UE_ROOT=/path/to/UnrealEngine Scripts/HUDBenchmark.sh [NumClients] [DurationSeconds] [Map]
+#
+# A LoadTest.sh comparison with bot clients that fire and reload, so ammo and carried ammo change:
+# once as shipped, once with Shooter.HUDInvalidation off. Slate still ticks and lays out widgets under
+# -nullrhi, only painting is skipped, so this compares widget tick and prepass cost. The overlay reads
+# the console variable when it's created, so it's set from the ini at startup.
+
+set -euo pipefail
+
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+
+OUTPUT_DIR="${OUTPUT_DIR:-$PROJECT_DIR/Saved/HUDBenchmark}" SUMMARY_COLUMNS='Slate|/UI$' \
+	exec "$PROJECT_DIR/Scripts/LoadTest.sh" --title "HUD benchmark" --names "Invalidation NoInvalidation" \
+	--compare "-ini:Engine:[ConsoleVariables]:Shooter.HUDInvalidation=0" \
+	"${1:-1}" "${2:-120}" "${3:-/Game/_Game/Maps/DefaultMap}"
@@ -0,0 +1,44 @@
+#!/usr/bin/env bash
+# Server net tick time with many resting items, dormant against always awake, with bot clients.
+#
+#   UE_ROOT=/path/to/UnrealEngine Scripts/ItemDormancyBenchmark.sh [NumItems] [NumClients] [DurationSeconds] [Map]
+#
+# A LoadTest.sh comparison on a localhost dedicated server that spawns NumItems stress items
+# (ShooterSpawnStressActors, needs StressItemClass on the game mode): once with Shooter.ItemDormancy
+# on, once with it off so every item is considered each net update. The bots pick up and drop a few
+# items, the rest never change. Compare NetworkOutgoing (the server's net tick: relevancy, property
+# comparison and send), frame and game thread time and bandwidth. The console variable is read when
+# the items spawn, so it's set from the ini at startup.
+#
+# Fails if fewer than 90% of the items were ever dormant at once in the dormant run: the comparison
+# means nothing if the spawned items never went dormant.
+
+set -euo pipefail
+
+NUM_ITEMS="${1:-10000}"
+
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+export OUTPUT_DIR="${OUTPUT_DIR:-$PROJECT_DIR/Saved/ItemDormancyBenchmark}"
+
+SERVER_ARGS="-ExecCmds=\"ShooterSpawnStressActors 0 $NUM_ITEMS\"" \
+	"$PROJECT_DIR/Scripts/LoadTest.sh" --title "Item dormancy benchmark, $NUM_ITEMS items" --names "Dormant Awake" \
+	--compare "-ini:Engine:[ConsoleVariables]:Shooter.ItemDormancy=0" \
+	"${2:-4}" "${3:-120}" "${4:-/Game/_Game/Maps/DefaultMap}"
+
+# Highest Shooter/DormantItems of the dormant run's server, rows as in LoadTest.sh
+RESULTS_DIR="$(ls -td "$OUTPUT_DIR"/*/ | head -n 1)"
+DORMANT_ITEMS="$(awk -F, '
+	NR == 1 {
+		NumFields = NF
+		for (f = 1; f <= NF; f++) if ($f == "Shooter/DormantItems") Column = f
+		next
+	}
+	NF == NumFields && $1 ~ /^[0-9.]+$/ && Column && $Column > Max { Max = $Column }
+	END { printf "%d\n", Max }' "$RESULTS_DIR/Dormant/Server.csv" 2>/dev/null || echo 0)"
+
+echo
+if ((DORMANT_ITEMS * 10 < NUM_ITEMS * 9)); then
+	echo "FAILED: at most $DORMANT_ITEMS of $NUM_ITEMS items were dormant in the dormant run" >&2
+	exit 1
+fi
+echo "$DORMANT_ITEMS of $NUM_ITEMS items dormant"
@@ -0,0 +1,23 @@
+#!/usr/bin/env bash
+# Client prediction under emulated latency: bot clients firing and reloading against a localhost server.
+#
+#   UE_ROOT=/path/to/UnrealEngine Scripts/LatencyTest.sh [NumClients] [DurationSeconds] [Map]
+#
+# A LoadTest.sh comparison of loopback against three network profiles. Every process delays its
+# outgoing packets by PktLag ms (+- PktLagVariance) and drops PktLoss percent of them (engine packet
+# simulation, not in Shipping), so the round trip is about twice PktLag. The report gives, per
+# profile, the clients' ping, their prediction corrections (ammo replayed on a server ack that differs
+# from the predicted value) and the server's rejected shots. Both should stay near zero with bots that
+# fire at the weapon's rate; corrections growing with lag point at the reconciliation.
+
+set -euo pipefail
+
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+SIM="-ini:Engine:[PacketSimulationSettings]"
+
+OUTPUT_DIR="${OUTPUT_DIR:-$PROJECT_DIR/Saved/LatencyTest}" \
+	exec "$PROJECT_DIR/Scripts/LoadTest.sh" --title "Latency test" --names "Loopback Lag50 Lag100 Lag200" \
+	--compare "$SIM:PktLag=50 $SIM:PktLagVariance=5 $SIM:PktLoss=0" \
+	--compare "$SIM:PktLag=100 $SIM:PktLagVariance=10 $SIM:PktLoss=1" \
+	--compare "$SIM:PktLag=200 $SIM:PktLagVariance=20 $SIM:PktLoss=2" \
+	"${1:-4}" "${2:-120}" "${3:-/Game/_Game/Maps/DefaultMap}"
@@ -0,0 +1,277 @@
+#!/usr/bin/env bash
+# Localhost load test: one dedicated server and N headless bot clients over loopback.
+#
+#   UE_ROOT=/path/to/UnrealEngine Scripts/LoadTest.sh [options] [NumClients] [DurationSeconds] [Map]
+#
+# Every process captures a CSV profile (-csvprofile) into its own Saved directory. The engine
+# records frame / game thread time, the Shooter category adds bandwidth, ping, GC time and the
+# server's dormant items (UShooterNetStatsSubsystem) and rejected shots / prediction corrections. The
+# summary of all of them is written to Saved/LoadTest/<date>/Report.txt (or $OUTPUT_DIR/<date>), with
+# one row per client connection. Clients run with -ShooterBot, see UShooterInputBotComponent.
+#
+# A/B runs: every --compare "<args>" adds a run with those arguments on every process after the
+# baseline run without them. Each run gets its own directory and report, the top Report.txt puts the
+# server's and the first client's averages (max) of all runs side by side.
+#
+#   --compare "<args>"   one more run with these extra arguments, can be given several times
+#   --names "<names>"    names of the baseline and the compared runs, default "Baseline Compare1 ..."
+#   --title "<text>"     first line of the report
+#
+# Uses the editor binary with -server / -game so it works on an uncooked tree; set UE_BINARY to a
+# packaged ShooterServer / Shooter build to measure without editor overhead.
+
+set -euo pipefail
+
+COMPARE_ARGS=()
+RUN_NAMES=()
+TITLE="Load test"
+while [[ $# -gt 0 && "$1" == --* ]]; do
+	case "$1" in
+		--compare) COMPARE_ARGS+=("$2"); shift 2 ;;
+		--names) read -r -a RUN_NAMES <<<"$2"; shift 2 ;;
+		--title) TITLE="$2"; shift 2 ;;
+		*) echo "unknown option $1" >&2; exit 1 ;;
+	esac
+done
+
+NUM_CLIENTS="${1:-8}"
+DURATION="${2:-120}"
+MAP="${3:-/Game/_Game/Maps/DefaultMap}"
+PORT="${PORT:-7777}"
+CLIENT_MAX_FPS="${CLIENT_MAX_FPS:-60}"
+# Extra arguments for every process, e.g. EXTRA_ARGS="-ExecCmds=\"Net PktLag=100\""
+EXTRA_ARGS="${EXTRA_ARGS:-}"
+# Extra arguments for the server only, e.g. SERVER_ARGS="-ExecCmds=\"ShooterSpawnStressActors 0 2000\""
+SERVER_ARGS="${SERVER_ARGS:-}"
+# Trace channels for an Unreal Insights trace of the server, written to <run>/Server.utrace
+SERVER_TRACE="${SERVER_TRACE:-}"
+# Regular expression of more CSV columns to summarize, e.g. SUMMARY_COLUMNS="Slate|/UI$"
+SUMMARY_COLUMNS="${SUMMARY_COLUMNS:-}"
+
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+PROJECT="$PROJECT_DIR/Shooter.uproject"
+: "${UE_ROOT:?Set UE_ROOT to the engine root}"
+UE_BINARY="${UE_BINARY:-$UE_ROOT/Engine/Binaries/Linux/UnrealEditor}"
+
+# Saved* directories are ignored by git
+OUTPUT_DIR="${OUTPUT_DIR:-$PROJECT_DIR/Saved/LoadTest}"
+RESULTS_DIR="$OUTPUT_DIR/$(date +%Y%m%d-%H%M%S)"
+mkdir -p "$RESULTS_DIR"
+
+PIDS=()
+stop_all()
+{
+	# SIGTERM lets each process end its CSV capture and write the file
+	for PID in "${PIDS[@]}"; do
+		kill -TERM "$PID" 2>/dev/null || true
+	done
+	for PID in "${PIDS[@]}"; do
+		wait "$PID" 2>/dev/null || true
+	done
+	PIDS=()
+}
+trap stop_all EXIT
+
+# Newest CSV of a process into the run directory
+collect()
+{
+	local RunDir="$1"
+	local Name="$2"
+	local Csv
+	Csv="$(ls -t "$PROJECT_DIR/Saved$3/Profiling/CSV/"*.csv 2>/dev/null | head -n 1 || true)"
+	if [[ -n "$Csv" ]]; then
+		cp "$Csv" "$RunDir/$Name.csv"
+	else
+		echo "warning: no CSV for $Name" >&2
+	fi
+}
+
+# "stat<TAB>avg<TAB>max" for the interesting columns of one CSV. The header is the first row,
+# metadata rows at the end have a different field count and are skipped.
+stats()
+{
+	awk -F, -v Columns="FrameTime,GameThreadTime,Exclusive/GameThread/NetworkOutgoing,Shooter/GarbageCollectMs,Shooter/NetConnections,Shooter/NetOutBytesPerSecTotal,Shooter/NetOutBytesPerSecMax,Shooter/NetInBytesPerSecTotal,Shooter/NetInBytesPerSecMax,Shooter/NetPingMsMax,Shooter/DormantItems,Shooter/STAT_ShooterRejectedShots,Shooter/STAT_ShooterPredictionCorrections" -v Pattern="$SUMMARY_COLUMNS" '
+		NR == 1 {
+			NumFields = NF
+			NumWanted = split(Columns, Wanted, ",")
+			for (f = 1; f <= NF; f++) if (Pattern != "" && $f ~ Pattern) Wanted[++NumWanted] = $f
+			for (c = 1; c <= NumWanted; c++) for (f = 1; f <= NF; f++) if ($f == Wanted[c]) Index[Wanted[c]] = f
+			next
+		}
+		NF == NumFields && $1 ~ /^[0-9.]+$/ {
+			Rows++
+			for (Name in Index) {
+				Value = $(Index[Name])
+				Sum[Name] += Value
+				if (Value > Max[Name]) Max[Name] = Value
+			}
+		}
+		END {
+			for (c = 1; c <= NumWanted; c++) {
+				Name = Wanted[c]
+				if (Name in Index && Rows > 0) printf "%s\t%.2f\t%.2f\n", Name, Sum[Name] / Rows, Max[Name]
+			}
+		}' "$1"
+}
+
+# Average / max of the interesting columns of one CSV
+summarize()
+{
+	printf "  %-44s %12s %12s\n" "stat" "avg" "max"
+	stats "$1" | awk -F'\t' '{ printf "  %-44s %12.2f %12.2f\n", $1, $2, $3 }'
+}
+
+# One row per connection: a client has only its server connection, so its in / out / ping are the
+# connection's, as the server would see them mirrored
+connection_row()
+{
+	awk -F, -v Name="$2" '
+		NR == 1 {
+			NumFields = NF
+			for (f = 1; f <= NF; f++) {
+				if ($f == "Shooter/NetOutBytesPerSecTotal") Out = f
+				if ($f == "Shooter/NetInBytesPerSecTotal") In = f
+				if ($f == "Shooter/NetPingMsMax") Ping = f
+			}
+			next
+		}
+		NF == NumFields && $1 ~ /^[0-9.]+$/ && Out && In && Ping {
+			Rows++
+			OutSum += $Out; if ($Out > OutMax) OutMax = $Out
+			InSum += $In; if ($In > InMax) InMax = $In
+			PingSum += $Ping; if ($Ping > PingMax) PingMax = $Ping
+		}
+		END {
+			if (Rows > 0) printf "  %-10s %10.0f %10.0f %10.0f %10.0f %8.1f %8.1f\n", Name, InSum / Rows, InMax, OutSum / Rows, OutMax, PingSum / Rows, PingMax
+			else printf "  %-10s no samples\n", Name
+		}' "$1"
+}
+
+connection_table()
+{
+	echo "Connections (bytes/s received from / sent to the server, ping ms)"
+	printf "  %-10s %10s %10s %10s %10s %8s %8s\n" "client" "in avg" "in max" "out avg" "out max" "ping avg" "ping max"
+	for ((i = 0; i < NUM_CLIENTS; i++)); do
+		if [[ -f "$1/Client$i.csv" ]]; then
+			connection_row "$1/Client$i.csv" "Client$i"
+		else
+			printf "  %-10s no CSV\n" "Client$i"
+		fi
+	done
+}
+
+# One run into RunDir, RunArgs go to every process
+run()
+{
+	local RunDir="$1"
+	local RunArgs="$2"
+	mkdir -p "$RunDir"
+
+	local TraceArgs=""
+	if [[ -n "$SERVER_TRACE" ]]; then
+		TraceArgs="-trace=$SERVER_TRACE -tracefile=$RunDir/Server.utrace"
+	fi
+
+	echo "Server on port $PORT, $NUM_CLIENTS clients for ${DURATION}s, results in $RunDir"
+
+	# shellcheck disable=SC2086
+	"$UE_BINARY" "$PROJECT" "$MAP" -server -nullrhi -unattended -nosound -port="$PORT" \
+		-csvprofile -SavedDirSuffix=LoadTestServer -abslog="$RunDir/Server.log" $EXTRA_ARGS $SERVER_ARGS $TraceArgs $RunArgs \
+		>/dev/null 2>&1 &
+	PIDS+=($!)
+
+	# Let the server load the map before the clients connect
+	sleep "${SERVER_WARMUP:-20}"
+
+	for ((i = 0; i < NUM_CLIENTS; i++)); do
+		# shellcheck disable=SC2086
+		"$UE_BINARY" "$PROJECT" "127.0.0.1:$PORT" -game -nullrhi -unattended -nosound \
+			-ShooterBot -ShooterBotSeed="$i" -csvprofile -SavedDirSuffix="LoadTestClient$i" \
+			-ExecCmds="t.MaxFPS $CLIENT_MAX_FPS" -abslog="$RunDir/Client$i.log" $EXTRA_ARGS $RunArgs \
+			>/dev/null 2>&1 &
+		PIDS+=($!)
+	done
+
+	sleep "$DURATION"
+	stop_all
+
+	collect "$RunDir" Server LoadTestServer
+	for ((i = 0; i < NUM_CLIENTS; i++)); do
+		collect "$RunDir" "Client$i" "LoadTestClient$i"
+	done
+
+	{
+		echo "$TITLE $(date), $NUM_CLIENTS clients, ${DURATION}s, map $MAP"
+		if [[ -n "$RunArgs" ]]; then
+			echo "Arguments: $RunArgs"
+		fi
+		echo
+		connection_table "$RunDir"
+		for Csv in "$RunDir"/*.csv; do
+			echo
+			echo "$(basename "$Csv" .csv)"
+			summarize "$Csv"
+		done
+	} >"$RunDir/Report.txt"
+}
+
+# "avg (max)" of one CSV of every run side by side, one column per run
+compare_table()
+{
+	local Csv="$1"
+	printf "  %-44s" "$Csv"
+	for Name in "${RUN_NAMES[@]}"; do
+		printf " %22s" "$Name"
+	done
+	echo
+	for ((r = 0; r < ${#RUN_NAMES[@]}; r++)); do
+		if [[ -f "$RESULTS_DIR/${RUN_NAMES[$r]}/$Csv.csv" ]]; then
+			stats "$RESULTS_DIR/${RUN_NAMES[$r]}/$Csv.csv" | sed "s/^/$r\t/"
+		fi
+	done | awk -F'\t' -v NumRuns="${#RUN_NAMES[@]}" '
+		{
+			if (!($2 in Seen)) { Seen[$2] = 1; Order[++NumStats] = $2 }
+			Cell[$2, $1] = sprintf("%.2f (%.2f)", $3, $4)
+		}
+		END {
+			for (s = 1; s <= NumStats; s++) {
+				printf "  %-44s", Order[s]
+				for (r = 0; r < NumRuns; r++) printf " %22s", ((Order[s], r) in Cell) ? Cell[Order[s], r] : "-"
+				printf "\n"
+			}
+		}'
+}
+
+if [[ ${#COMPARE_ARGS[@]} -eq 0 ]]; then
+	run "$RESULTS_DIR" ""
+	trap - EXIT
+	cat "$RESULTS_DIR/Report.txt"
+	exit 0
+fi
+
+# Baseline, then one run per --compare
+RUN_ARGS=("" "${COMPARE_ARGS[@]}")
+for ((r = ${#RUN_NAMES[@]}; r < ${#RUN_ARGS[@]}; r++)); do
+	RUN_NAMES[$r]="$([[ $r -eq 0 ]] && echo Baseline || echo "Compare$r")"
+done
+for ((r = 0; r < ${#RUN_ARGS[@]}; r++)); do
+	run "$RESULTS_DIR/${RUN_NAMES[$r]}" "${RUN_ARGS[$r]}"
+done
+trap - EXIT
+
+REPORT="$RESULTS_DIR/Report.txt"
+{
+	echo "$TITLE $(date), $NUM_CLIENTS clients, ${DURATION}s, map $MAP"
+	for ((r = 0; r < ${#RUN_ARGS[@]}; r++)); do
+		echo
+		echo "== ${RUN_NAMES[$r]}: ${RUN_ARGS[$r]:-no extra arguments}"
+		connection_table "$RESULTS_DIR/${RUN_NAMES[$r]}"
+	done
+	echo
+	echo "Average (max) per run"
+	compare_table Server
+	echo
+	compare_table Client0
+} >"$REPORT"
+
+cat "$REPORT"
@@ -0,0 +1,21 @@
+#!/usr/bin/env bash
+# Server cost of comparing replicated properties, push model against the default comparison, with bot clients.
+#
+#   UE_ROOT=/path/to/UnrealEngine Scripts/PushModelBenchmark.sh [NumClients] [DurationSeconds] [NumCharacters] [Map]
+#
+# A LoadTest.sh comparison with the same scripted clients, which fire, reload, crouch and aim: once with
+# net.IsPushModelEnabled from DefaultEngine.ini, once with it off so every replicated property is
+# compared every net update. The server also spawns NumCharacters stress characters. Compare the
+# server's NetworkOutgoing (where property comparison runs), frame and game thread time. Each server
+# also writes <run>/Server.utrace; open both in Unreal Insights and compare the ReplicateActor /
+# CompareProperties timers for the property comparison alone.
+
+set -euo pipefail
+
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+
+OUTPUT_DIR="${OUTPUT_DIR:-$PROJECT_DIR/Saved/PushModelBenchmark}" SERVER_TRACE=cpu,net \
+	SERVER_ARGS="-ExecCmds=\"ShooterSpawnStressActors ${3:-32} 0\"" \
+	exec "$PROJECT_DIR/Scripts/LoadTest.sh" --title "Push model benchmark, ${3:-32} characters" --names "PushModel Compare" \
+	--compare "-ini:Engine:[SystemSettings]:net.IsPushModelEnabled=0" \
+	"${1:-16}" "${2:-120}" "${4:-/Game/_Game/Maps/DefaultMap}"
@@ -0,0 +1,20 @@
+#!/usr/bin/env bash
+# Server cost of ShooterReplicationGraph against the engine's default replication, with bot clients.
+#
+#   UE_ROOT=/path/to/UnrealEngine Scripts/RepGraphBenchmark.sh [NumClients] [DurationSeconds] [NumItems] [Map]
+#
+# A LoadTest.sh comparison with the same scripted clients: once with the replication graph from
+# DefaultEngine.ini, once with ReplicationDriverClassName cleared. The server spawns NumItems stress
+# items first (ShooterSpawnStressActors, needs StressItemClass on the game mode) so relevancy has
+# something to cull. Compare the server's frame and game thread time, NetworkOutgoing (relevancy,
+# replication and send) and bandwidth, and each run's connections.
+
+set -euo pipefail
+
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+
+OUTPUT_DIR="${OUTPUT_DIR:-$PROJECT_DIR/Saved/RepGraphBenchmark}" \
+	SERVER_ARGS="-ExecCmds=\"ShooterSpawnStressActors 0 ${3:-2000}\"" \
+	exec "$PROJECT_DIR/Scripts/LoadTest.sh" --title "Replication graph benchmark, ${3:-2000} items" --names "Graph Default" \
+	--compare "-ini:Engine:[/Script/OnlineSubsystemUtils.IpNetDriver]:ReplicationDriverClassName=" \
+	"${1:-16}" "${2:-120}" "${4:-/Game/_Game/Maps/DefaultMap}"
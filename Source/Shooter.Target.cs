@@ -9,6 +9,7 @@ public class ShooterTarget : TargetRules
 	{
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
+		bWithPushModel = true;
 		ExtraModuleNames.AddRange( new string[] { "Shooter" } );
 	}
 }
@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CombatFXSubsystem.h"
+#include "Shooter.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "GameFramework/WorldSettings.h"
+
+UCombatFXSubsystem::UCombatFXSubsystem() :
+	MaxComponentsPerTemplate(32)
+{
+}
+
+void UCombatFXSubsystem::Deinitialize()
+{
+	for (auto& Pair : Pools)
+	{
+		for (UParticleSystemComponent* PSC : Pair.Value.Free)
+		{
+			if (IsValid(PSC))
+			{
+				PSC->DestroyComponent();
+			}
+		}
+		for (UParticleSystemComponent* PSC : Pair.Value.Active)
+		{
+			if (IsValid(PSC))
+			{
+				PSC->DestroyComponent();
+			}
+		}
+	}
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+void UCombatFXSubsystem::Prewarm(UParticleSystem* Template, int32 Count)
+{
+	if (Template == nullptr) return;
+
+	FCombatFXPool& Pool = Pools.FindOrAdd(Template);
+	Count = FMath::Min(Count, MaxComponentsPerTemplate - Pool.Active.Num());
+	while (Pool.Free.Num() < Count)
+	{
+		UParticleSystemComponent* PSC = CreatePooledComponent(Template);
+		if (PSC == nullptr) break;
+		// Create the emitter instances now rather than on first activation
+		PSC->InitializeSystem();
+		Pool.Free.Add(PSC);
+	}
+}
+
+UParticleSystemComponent* UCombatFXSubsystem::SpawnAtLocation(UParticleSystem* Template, const FTransform& Transform)
+{
+	if (Template == nullptr) return nullptr;
+
+	FCombatFXPool& Pool = Pools.FindOrAdd(Template);
+	UParticleSystemComponent* PSC = nullptr;
+
+	// Free component
+	while (Pool.Free.Num() > 0 && PSC == nullptr)
+	{
+		PSC = Pool.Free.Pop(false);
+		if (!IsValid(PSC))
+		{
+			PSC = nullptr;
+		}
+	}
+
+	if (PSC)
+	{
+		Stats.Hits++;
+		SHOOTER_INC_COUNTER(STAT_ShooterFXPoolHits);
+	}
+	else if (Pool.Free.Num() + Pool.Active.Num() < MaxComponentsPerTemplate)
+	{
+		// Pool not full yet, grow it
+		Stats.Misses++;
+		SHOOTER_INC_COUNTER(STAT_ShooterFXPoolMisses);
+		PSC = CreatePooledComponent(Template);
+	}
+	else if (Pool.Active.Num() > 0)
+	{
+		// Pool at cap, restart the oldest active component
+		Stats.Evictions++;
+		SHOOTER_INC_COUNTER(STAT_ShooterFXPoolEvictions);
+		PSC = Pool.Active[0];
+		Pool.Active.RemoveAt(0, 1, false);
+		if (IsValid(PSC))
+		{
+			PSC->DeactivateImmediate();
+		}
+		else
+		{
+			PSC = CreatePooledComponent(Template);
+		}
+	}
+
+	if (PSC == nullptr) return nullptr;
+
+	SHOOTER_INC_COUNTER(STAT_ShooterFXSpawns);
+	Pool.Active.Add(PSC);
+	PSC->SetWorldTransform(Transform);
+	PSC->ActivateSystem(true);
+	return PSC;
+}
+
+UParticleSystemComponent* UCombatFXSubsystem::SpawnAtLocation(UParticleSystem* Template, const FVector& Location)
+{
+	return SpawnAtLocation(Template, FTransform(Location));
+}
+
+UParticleSystemComponent* UCombatFXSubsystem::CreatePooledComponent(UParticleSystem* Template)
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr) return nullptr;
+
+	// Same outer UGameplayStatics uses for emitters spawned at a location
+	UParticleSystemComponent* PSC = NewObject<UParticleSystemComponent>(
+		World->GetWorldSettings() ? (UObject*)World->GetWorldSettings() : (UObject*)World);
+	PSC->bAutoDestroy = false;
+	PSC->bAutoActivate = false;
+	PSC->SetAbsolute(true, true, true);
+	PSC->SetTemplate(Template);
+	PSC->OnSystemFinished.AddDynamic(this, &UCombatFXSubsystem::OnPooledSystemFinished);
+	PSC->RegisterComponentWithWorld(World);
+	return PSC;
+}
+
+void UCombatFXSubsystem::OnPooledSystemFinished(UParticleSystemComponent* PSC)
+{
+	if (PSC == nullptr) return;
+
+	FCombatFXPool* Pool = Pools.Find(PSC->Template);
+	if (Pool && Pool->Active.RemoveSingle(PSC) > 0)
+	{
+		Pool->Free.Add(PSC);
+	}
+}
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatFXSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+/** Pool hit / miss / eviction counters, summed over every template */
+USTRUCT(BlueprintType)
+struct FCombatFXPoolStats
+{
+	GENERATED_BODY()
+
+	/** Spawns served by a free pooled component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat FX")
+	int32 Hits = 0;
+
+	/** Spawns that had to create a new component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat FX")
+	int32 Misses = 0;
+
+	/** Spawns that reused the oldest active component because the pool was at its cap */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat FX")
+	int32 Evictions = 0;
+};
+
+/** Components owned by one particle template */
+USTRUCT()
+struct FCombatFXPool
+{
+	GENERATED_BODY()
+
+	/** Components ready to be handed out */
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> Free;
+
+	/** Components currently playing, oldest first */
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> Active;
+};
+
+/**
+ * Keeps pre-warmed particle components per template so firing does not
+ * create, register and garbage collect a component for every shot.
+ */
+UCLASS()
+class SHOOTER_API UCombatFXSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UCombatFXSubsystem();
+
+	virtual void Deinitialize() override;
+
+	/** Creates components for Template until Count are free in its pool */
+	void Prewarm(UParticleSystem* Template, int32 Count);
+
+	/** Plays Template at Transform with a pooled component, returns null if Template is null */
+	UParticleSystemComponent* SpawnAtLocation(UParticleSystem* Template, const FTransform& Transform);
+	UParticleSystemComponent* SpawnAtLocation(UParticleSystem* Template, const FVector& Location);
+
+	UFUNCTION(BlueprintCallable, Category = "Combat FX")
+	FCombatFXPoolStats GetPoolStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "Combat FX")
+	void ResetPoolStats() { Stats = FCombatFXPoolStats(); }
+
+private:
+	UParticleSystemComponent* CreatePooledComponent(UParticleSystem* Template);
+
+	UFUNCTION()
+	void OnPooledSystemFinished(UParticleSystemComponent* PSC);
+
+	UPROPERTY()
+	TMap<UParticleSystem*, FCombatFXPool> Pools;
+
+	/** Max components (free + active) per template */
+	int32 MaxComponentsPerTemplate;
+
+	FCombatFXPoolStats Stats;
+};
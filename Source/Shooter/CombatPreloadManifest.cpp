@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CombatPreloadManifest.h"
+#include "Shooter.h"
+#include "CombatFXSubsystem.h"
+#include "Particles/ParticleSystem.h"
+#include "Animation/AnimMontage.h"
+#include "Sound/SoundCue.h"
+#include "Sound/SoundWave.h"
+#include "Sound/SoundNodeWavePlayer.h"
+#include "AudioDevice.h"
+
+void FCombatPreloadManifest::AddParticleSystem(UParticleSystem* ParticleSystem)
+{
+	AddEntry(ECombatPreloadAssetType::Particles, ParticleSystem, NAME_None);
+}
+
+void FCombatPreloadManifest::AddSound(USoundBase* Sound)
+{
+	AddEntry(ECombatPreloadAssetType::Sound, Sound, NAME_None);
+}
+
+void FCombatPreloadManifest::AddMontage(UAnimMontage* Montage, FName Section)
+{
+	AddEntry(ECombatPreloadAssetType::Montage, Montage, Section);
+}
+
+void FCombatPreloadManifest::AddEntry(ECombatPreloadAssetType Type, UObject* Asset, FName Section)
+{
+	if (Asset == nullptr) return;
+
+	const bool bAlreadyAdded = Entries.ContainsByPredicate([Asset, Section](const FCombatPreloadEntry& Entry)
+	{
+		return Entry.Asset == Asset && Entry.Section == Section;
+	});
+	if (bAlreadyAdded) return;
+
+	FCombatPreloadEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Type = Type;
+	Entry.Asset = Asset;
+	Entry.Section = Section;
+}
+
+void FCombatPreloadManifest::Warm(UWorld* World, int32 FXPrewarmCount)
+{
+	if (World == nullptr) return;
+
+	for (FCombatPreloadEntry& Entry : Entries)
+	{
+		UObject* Asset = Entry.Asset.Get();
+		if (Entry.bWarmed || Asset == nullptr) continue;
+
+		const double StartSeconds = FPlatformTime::Seconds();
+		switch (Entry.Type)
+		{
+		case ECombatPreloadAssetType::Particles:
+			WarmParticleSystem(World, CastChecked<UParticleSystem>(Asset), FXPrewarmCount);
+			break;
+		case ECombatPreloadAssetType::Sound:
+			WarmSound(World, CastChecked<USoundBase>(Asset));
+			break;
+		case ECombatPreloadAssetType::Montage:
+			Entry.SectionIndex = WarmMontage(CastChecked<UAnimMontage>(Asset), Entry.Section);
+			break;
+		}
+		Entry.WarmSeconds = FPlatformTime::Seconds() - StartSeconds;
+		Entry.bWarmed = true;
+	}
+}
+
+void FCombatPreloadManifest::LogTimings(const FString& OwnerName) const
+{
+	double TotalSeconds = 0.0;
+	for (const FCombatPreloadEntry& Entry : Entries)
+	{
+		if (!Entry.bWarmed) continue;
+
+		TotalSeconds += Entry.WarmSeconds;
+		UE_LOG(LogShooter, Verbose, TEXT("%s: warmed %s %s in %.3f ms"),
+			*OwnerName,
+			*GetNameSafe(Entry.Asset.Get()),
+			Entry.Section.IsNone() ? TEXT("") : *Entry.Section.ToString(),
+			Entry.WarmSeconds * 1000.0);
+	}
+	UE_LOG(LogShooter, Verbose, TEXT("%s: combat preload total %.3f ms"), *OwnerName, TotalSeconds * 1000.0);
+}
+
+int32 FCombatPreloadManifest::FindMontageSectionIndex(const UAnimMontage* Montage, FName Section) const
+{
+	if (Montage == nullptr) return INDEX_NONE;
+
+	const FCombatPreloadEntry* Entry = Entries.FindByPredicate([Montage, Section](const FCombatPreloadEntry& Other)
+	{
+		return Other.bWarmed && Other.Asset == Montage && Other.Section == Section;
+	});
+	return Entry ? Entry->SectionIndex : Montage->GetSectionIndex(Section);
+}
+
+void FCombatPreloadManifest::WarmParticleSystem(UWorld* World, UParticleSystem* ParticleSystem, int32 FXPrewarmCount)
+{
+	if (UCombatFXSubsystem* FXSubsystem = World->GetSubsystem<UCombatFXSubsystem>())
+	{
+		FXSubsystem->Prewarm(ParticleSystem, FXPrewarmCount);
+	}
+}
+
+void FCombatPreloadManifest::WarmSound(UWorld* World, USoundBase* Sound)
+{
+	FAudioDevice* AudioDevice = World->GetAudioDeviceRaw();
+	if (AudioDevice == nullptr) return;
+
+	// Waves played by the cue
+	TArray<USoundWave*> SoundWaves;
+	if (USoundCue* SoundCue = Cast<USoundCue>(Sound))
+	{
+		TArray<USoundNodeWavePlayer*> WavePlayers;
+		SoundCue->RecursiveFindNode<USoundNodeWavePlayer>(SoundCue->FirstNode, WavePlayers);
+		for (USoundNodeWavePlayer* WavePlayer : WavePlayers)
+		{
+			if (WavePlayer && WavePlayer->GetSoundWave())
+			{
+				SoundWaves.AddUnique(WavePlayer->GetSoundWave());
+			}
+		}
+	}
+	else if (USoundWave* SoundWave = Cast<USoundWave>(Sound))
+	{
+		SoundWaves.Add(SoundWave);
+	}
+
+	for (USoundWave* SoundWave : SoundWaves)
+	{
+		AudioDevice->Precache(SoundWave, true, true, true);
+	}
+}
+
+int32 FCombatPreloadManifest::WarmMontage(UAnimMontage* Montage, FName Section)
+{
+	if (Section.IsNone()) return INDEX_NONE;
+
+	const int32 SectionIndex = Montage->GetSectionIndex(Section);
+	if (SectionIndex == INDEX_NONE)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Montage %s has no section %s"), *Montage->GetName(), *Section.ToString());
+	}
+	return SectionIndex;
+}
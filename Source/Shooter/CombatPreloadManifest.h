@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UParticleSystem;
+class USoundBase;
+class UAnimMontage;
+
+enum class ECombatPreloadAssetType : uint8
+{
+	Particles,
+	Sound,
+	Montage
+};
+
+/** One asset of the manifest and how long warming it took */
+struct FCombatPreloadEntry
+{
+	ECombatPreloadAssetType Type;
+	TWeakObjectPtr<UObject> Asset;
+
+	/** Montage section to resolve, NAME_None for other assets */
+	FName Section;
+	int32 SectionIndex = INDEX_NONE;
+
+	bool bWarmed = false;
+	double WarmSeconds = 0.0;
+};
+
+/**
+ * Combat assets of a character (fire sound, FX, montages) that are warmed while loading,
+ * so the first shot and first reload don't pay for lazy initialization.
+ */
+struct SHOOTER_API FCombatPreloadManifest
+{
+	void AddParticleSystem(UParticleSystem* ParticleSystem);
+	void AddSound(USoundBase* Sound);
+	void AddMontage(UAnimMontage* Montage, FName Section);
+
+	/** Warms every entry not warmed yet: pooled FX components are created and initialized,
+	 * sound waves are decompressed and montage sections resolved. */
+	void Warm(UWorld* World, int32 FXPrewarmCount);
+
+	/** Logs the time each asset took to warm, Verbose as it runs on every equip */
+	void LogTimings(const FString& OwnerName) const;
+
+	/** Index of Section in Montage, resolved while warming if the manifest has it */
+	int32 FindMontageSectionIndex(const UAnimMontage* Montage, FName Section) const;
+
+	FORCEINLINE const TArray<FCombatPreloadEntry>& GetEntries() const { return Entries; }
+
+private:
+	void AddEntry(ECombatPreloadAssetType Type, UObject* Asset, FName Section);
+
+	void WarmParticleSystem(UWorld* World, UParticleSystem* ParticleSystem, int32 FXPrewarmCount);
+	void WarmSound(UWorld* World, USoundBase* Sound);
+	int32 WarmMontage(UAnimMontage* Montage, FName Section);
+
+	TArray<FCombatPreloadEntry> Entries;
+};
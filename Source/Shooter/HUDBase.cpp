@@ -2,4 +2,105 @@
 
 
 #include "HUDBase.h"
+#include "ShooterCharacter.h"
+#include "Engine/Canvas.h"
+#include "Engine/Texture2D.h"
 
+AHUDBase::AHUDBase() :
+	// Crosshair
+	CrosshairCenter(nullptr),
+	CrosshairLeft(nullptr),
+	CrosshairRight(nullptr),
+	CrosshairTop(nullptr),
+	CrosshairBottom(nullptr),
+	CrosshairTileSize(64.f),
+	CrosshairSpreadMax(16.f),
+	CrosshairColor(FLinearColor::White),
+	CachedSpreadMultiplier(-1.f),
+	CachedViewportSize(FVector2D::ZeroVector)
+{
+}
+
+void AHUDBase::DrawHUD()
+{
+	Super::DrawHUD();
+
+	if (Canvas == nullptr) return;
+
+	const AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(GetOwningPawn());
+	if (ShooterCharacter == nullptr) return;
+
+	UpdateCrosshairLayout(
+		ShooterCharacter->GetCrosshairSpreadMultiplier(),
+		FVector2D(Canvas->ClipX, Canvas->ClipY));
+
+	// One cached triangle item per texture, a draw call each. Going through DrawItem keeps
+	// the canvas' transform stack (DPI scale, safe zone) on them like any other HUD draw
+	for (FCrosshairBatch& Batch : CrosshairBatches)
+	{
+		Batch.Item.Texture = Batch.Texture->GetResource();
+		if (Batch.Item.Texture == nullptr || Batch.Item.TriangleList.Num() == 0) continue;
+
+		Canvas->DrawItem(Batch.Item);
+	}
+}
+
+void AHUDBase::UpdateCrosshairLayout(float SpreadMultiplier, const FVector2D& ViewportSize)
+{
+	if (SpreadMultiplier == CachedSpreadMultiplier && ViewportSize == CachedViewportSize) return;
+
+	CachedSpreadMultiplier = SpreadMultiplier;
+	CachedViewportSize = ViewportSize;
+
+	// Same screen point TraceFromCrosshair deprojects
+	const FVector2D HalfTile{ CrosshairTileSize * 0.5f, CrosshairTileSize * 0.5f };
+	const float Spread{ SpreadMultiplier * CrosshairSpreadMax };
+	const FVector2D CenterPosition{ ViewportSize * 0.5f - HalfTile };
+
+	// Textures don't change, keep the batches and their triangle memory
+	for (FCrosshairBatch& Batch : CrosshairBatches)
+	{
+		Batch.Item.TriangleList.Reset();
+	}
+	AddCrosshairTile(CrosshairCenter, CenterPosition);
+	AddCrosshairTile(CrosshairLeft, CenterPosition - FVector2D(Spread, 0.f));
+	AddCrosshairTile(CrosshairRight, CenterPosition + FVector2D(Spread, 0.f));
+	AddCrosshairTile(CrosshairTop, CenterPosition - FVector2D(0.f, Spread));
+	AddCrosshairTile(CrosshairBottom, CenterPosition + FVector2D(0.f, Spread));
+}
+
+void AHUDBase::AddCrosshairTile(UTexture2D* Texture, const FVector2D& Position)
+{
+	if (Texture == nullptr) return;
+
+	FCrosshairBatch* Batch = CrosshairBatches.FindByPredicate([Texture](const FCrosshairBatch& Other)
+	{
+		return Other.Texture == Texture;
+	});
+	if (Batch == nullptr)
+	{
+		Batch = &CrosshairBatches.Emplace_GetRef(Texture);
+	}
+
+	const FVector2D Size{ CrosshairTileSize, CrosshairTileSize };
+	const FVector2D Corners[4] = {
+		Position,
+		Position + FVector2D(Size.X, 0.f),
+		Position + Size,
+		Position + FVector2D(0.f, Size.Y) };
+	const FVector2D UVs[4] = { FVector2D(0.f, 0.f), FVector2D(1.f, 0.f), FVector2D(1.f, 1.f), FVector2D(0.f, 1.f) };
+
+	for (const int32 First : { 1, 2 })
+	{
+		FCanvasUVTri& Triangle = Batch->Item.TriangleList.AddDefaulted_GetRef();
+		Triangle.V0_Pos = Corners[0];
+		Triangle.V0_UV = UVs[0];
+		Triangle.V0_Color = CrosshairColor;
+		Triangle.V1_Pos = Corners[First];
+		Triangle.V1_UV = UVs[First];
+		Triangle.V1_Color = CrosshairColor;
+		Triangle.V2_Pos = Corners[First + 1];
+		Triangle.V2_UV = UVs[First + 1];
+		Triangle.V2_Color = CrosshairColor;
+	}
+}
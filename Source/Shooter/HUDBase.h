@@ -4,17 +4,76 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/HUD.h"
+#include "CanvasTypes.h"
+#include "CanvasItem.h"
 #include "HUDBase.generated.h"
 
+class UTexture2D;
+
+/** Crosshair tiles sharing one texture, two triangles each, drawn as one canvas item */
+struct FCrosshairBatch
+{
+	explicit FCrosshairBatch(UTexture2D* InTexture) :
+		Texture(InTexture),
+		Item(TArray<FCanvasUVTri>(), nullptr)
+	{
+		Item.BlendMode = SE_BLEND_Translucent;
+	}
+
+	UTexture2D* Texture;
+	FCanvasTriangleItem Item;
+};
+
 /**
- * 
+ * Draws the crosshair natively from the character's spread multiplier
  */
 UCLASS()
 class SHOOTER_API AHUDBase : public AHUD
 {
 	GENERATED_BODY()
 
+public:
+	AHUDBase();
+
+	virtual void DrawHUD() override;
+
+private:
+	/** Rebuilds the cached crosshair triangles if the spread or the viewport changed */
+	void UpdateCrosshairLayout(float SpreadMultiplier, const FVector2D& ViewportSize);
+
+	/** Adds the two triangles of a tile at Position to the batch of Texture */
+	void AddCrosshairTile(UTexture2D* Texture, const FVector2D& Position);
+
+#pragma region Crosshair
+	UPROPERTY(EditDefaultsOnly, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
+	UTexture2D* CrosshairCenter;
+
+	UPROPERTY(EditDefaultsOnly, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
+	UTexture2D* CrosshairLeft;
+
+	UPROPERTY(EditDefaultsOnly, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
+	UTexture2D* CrosshairRight;
+
+	UPROPERTY(EditDefaultsOnly, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
+	UTexture2D* CrosshairTop;
+
+	UPROPERTY(EditDefaultsOnly, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
+	UTexture2D* CrosshairBottom;
+
+	/** Size each crosshair texture is drawn at */
+	UPROPERTY(EditDefaultsOnly, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
+	float CrosshairTileSize;
+
+	/** Distance the side textures move away from the center per unit of spread multiplier */
+	UPROPERTY(EditDefaultsOnly, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
+	float CrosshairSpreadMax;
+
+	UPROPERTY(EditDefaultsOnly, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
+	FLinearColor CrosshairColor;
 
-	
-	
+	// Triangles of the last drawn frame, rebuilt only when the inputs change
+	float CachedSpreadMultiplier;
+	FVector2D CachedViewportSize;
+	TArray<FCrosshairBatch, TInlineAllocator<5>> CrosshairBatches;
+#pragma endregion
 };
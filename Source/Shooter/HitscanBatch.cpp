@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitscanBatch.h"
+#include "Shooter.h"
+#include "Engine/World.h"
+#include "WorldCollision.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+void FHitscanBatch::AddConeRays(const FVector& Direction, float Length, float ConeHalfAngle, int32 Count, int32 Seed)
+{
+	FRandomStream RayStream(Seed);
+	for (int32 Ray = 0; Ray < Count; ++Ray)
+	{
+		Ends.Add(Start + RayStream.VRandCone(Direction, ConeHalfAngle) * Length);
+	}
+}
+
+void FHitscanBatch::TraceSync(UWorld* World)
+{
+	Hits.Reset();
+	Hits.SetNum(Ends.Num());
+	if (World == nullptr) return;
+
+	SHOOTER_INC_COUNTER_BY(STAT_ShooterTraces, Ends.Num());
+	for (int32 Index = 0; Index < Ends.Num(); ++Index)
+	{
+		World->LineTraceSingleByChannel(
+			Hits[Index],
+			Start,
+			Ends[Index],
+			TraceChannel,
+			QueryParams);
+	}
+}
+
+void FHitscanBatch::TraceAsync(UWorld* World, const TSharedRef<FHitscanBatch>& Batch, FOnHitscanBatchResolved OnResolved)
+{
+	Batch->Hits.Reset();
+	Batch->Hits.SetNum(Batch->Ends.Num());
+	Batch->NumPendingRays = Batch->Ends.Num();
+	if (World == nullptr || Batch->NumPendingRays == 0)
+	{
+		OnResolved.ExecuteIfBound(*Batch);
+		return;
+	}
+
+	// The rays run on the async trace workers with the rest of this frame's traces, the game
+	// thread only queues them. Their delegates all fire next frame, the last one resolves the batch
+	SHOOTER_INC_COUNTER_BY(STAT_ShooterTraces, Batch->Ends.Num());
+	for (int32 Index = 0; Index < Batch->Ends.Num(); ++Index)
+	{
+		FTraceDelegate TraceDelegate = FTraceDelegate::CreateLambda(
+			[Batch, OnResolved, Index](const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+			{
+				if (TraceDatum.OutHits.Num() > 0)
+				{
+					Batch->Hits[Index] = TraceDatum.OutHits[0];
+				}
+				if (--Batch->NumPendingRays == 0)
+				{
+					OnResolved.ExecuteIfBound(*Batch);
+				}
+			});
+
+		World->AsyncLineTraceByChannel(
+			EAsyncTraceType::Single,
+			Batch->Start,
+			Batch->Ends[Index],
+			Batch->TraceChannel,
+			Batch->QueryParams,
+			FCollisionResponseParams::DefaultResponseParam,
+			&TraceDelegate);
+	}
+}
+
+void FHitscanBatch::GroupImpactsBySurface(TArray<FHitscanImpactGroup, TInlineAllocator<16>>& OutGroups) const
+{
+	OutGroups.Reset();
+
+	for (int32 Index = 0; Index < Hits.Num(); ++Index)
+	{
+		const FHitResult& Hit = Hits[Index];
+
+		FHitscanImpactGroup* Group = OutGroups.FindByPredicate([&Hit](const FHitscanImpactGroup& Other)
+		{
+			return Other.bBlockingHit == Hit.bBlockingHit &&
+				Other.Component == Hit.Component &&
+				Other.PhysMaterial == Hit.PhysMaterial;
+		});
+		if (Group == nullptr)
+		{
+			Group = &OutGroups.AddDefaulted_GetRef();
+			Group->bBlockingHit = Hit.bBlockingHit;
+			Group->Component = Hit.Component;
+			Group->PhysMaterial = Hit.PhysMaterial;
+			Group->Normal = FVector::ZeroVector;
+		}
+
+		Group->Location += Hit.bBlockingHit ? FVector(Hit.Location) : Ends[Index];
+		Group->Normal += Hit.bBlockingHit ? FVector(Hit.ImpactNormal) : FVector::ZeroVector;
+		Group->Count++;
+	}
+
+	for (FHitscanImpactGroup& Group : OutGroups)
+	{
+		Group.Location /= Group.Count;
+		Group.Normal = Group.Normal.GetSafeNormal(SMALL_NUMBER, FVector::UpVector);
+	}
+}
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "CollisionQueryParams.h"
+
+struct FHitscanBatch;
+
+DECLARE_DELEGATE_OneParam(FOnHitscanBatchResolved, const FHitscanBatch&);
+
+/** Impacts of one batch that landed on the same surface */
+struct FHitscanImpactGroup
+{
+	/** Average location of the grouped hits, or of the trace ends for misses */
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::UpVector;
+	int32 Count = 0;
+	bool bBlockingHit = false;
+
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+	TWeakObjectPtr<UPhysicalMaterial> PhysMaterial;
+};
+
+/**
+ * Rays of one shot (e.g. shotgun pellets) that share a start point and query params.
+ * Every ray is a plain line trace, submitted together: one loop on the game thread, or all
+ * of them in this frame's async trace queue, resolved with a single callback.
+ */
+struct SHOOTER_API FHitscanBatch
+{
+	FVector Start = FVector::ZeroVector;
+	TArray<FVector, TInlineAllocator<16>> Ends;
+
+	/** One result per entry in Ends, filled when the batch resolves */
+	TArray<FHitResult, TInlineAllocator<16>> Hits;
+
+	ECollisionChannel TraceChannel = ECollisionChannel::ECC_Visibility;
+	FCollisionQueryParams QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(HitscanBatch), false);
+
+	/** Adds Count rays of Length in a cone around Direction, the same rays for the same Seed */
+	void AddConeRays(const FVector& Direction, float Length, float ConeHalfAngle, int32 Count, int32 Seed);
+
+	/** Every ray on the game thread, a single ray is exactly one LineTraceSingleByChannel */
+	void TraceSync(UWorld* World);
+
+	/** Queues every ray in the async trace queue this frame, OnResolved runs once the last one is back */
+	static void TraceAsync(UWorld* World, const TSharedRef<FHitscanBatch>& Batch, FOnHitscanBatchResolved OnResolved);
+
+	/** Merges hits by component and physical material; all misses end up in one group */
+	void GroupImpactsBySurface(TArray<FHitscanImpactGroup, TInlineAllocator<16>>& OutGroups) const;
+
+private:
+	/** Async rays not back yet, see TraceAsync */
+	int32 NumPendingRays = 0;
+};
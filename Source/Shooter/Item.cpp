@@ -1,112 +1,147 @@
 #include "Item.h"
+#include "Shooter.h"
 #include "Components/BoxComponent.h"
-#include "Components/WidgetComponent.h"
 #include "Components/SphereComponent.h"
 #include "ShooterCharacter.h"
+#include "ItemProximitySubsystem.h"
+#include "ItemTickSubsystem.h"
+#include "ItemProxySubsystem.h"
+#include "ShooterBenchmarkSubsystem.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Engine/CollisionProfile.h"
+
+static TAutoConsoleVariable<bool> CVarShooterItemDormancy(
+	TEXT("Shooter.ItemDormancy"),
+	true,
+	TEXT("Keep resting items net dormant until their state changes. Off keeps every item awake,\n")
+	TEXT("the baseline of Scripts/ItemDormancyBenchmark.sh; set it before the items spawn."));
+
+namespace
+{
+	/** States an item sits in until someone picks it up, dormant on the server */
+	bool IsResting(EItemState State)
+	{
+		return State == EItemState::EIS_Idle || State == EItemState::EIS_Pickup;
+	}
+}
 
 // Sets default values
+const FName AItem::PickupBoxProfileName(TEXT("ItemPickupBox"));
+const FName AItem::FallingMeshProfileName(TEXT("ItemFallingMesh"));
+
 AItem::AItem():
+	PickupWidgetOffset(0.f, 0.f, 50.f),
 	ItemName(FString("Default")),
 	ItemCount(1),
-	ItemState(EItemState::EIS_Idle)
+	ItemState(EItemState::EIS_Idle),
+	ItemTickIndex(INDEX_NONE),
+	ProximityQueryId(0),
+	ProxyMesh(nullptr),
+	ItemProxyIndex(INDEX_NONE)
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// Ticked by UItemTickSubsystem only while needed
+	PrimaryActorTick.bCanEverTick = false;
 
+	// Items resting in the level stay dormant until their state changes, see UpdateNetDormancy
+	bReplicates = true;
+	SetReplicatingMovement(true);
+	NetDormancy = DORM_Initial;
+
+	// Start in the Idle profiles so the first SetItemProperties has nothing to swap
 	ItemMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("ItemMesh"));
+	ItemMesh->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
 	SetRootComponent(ItemMesh);
 
 	CollisionBox = CreateDefaultSubobject<UBoxComponent>(TEXT("CollisionBox"));
 	CollisionBox->SetupAttachment(ItemMesh);
-	// block visibility
-	//CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-	CollisionBox->SetCollisionResponseToChannel(
-		ECollisionChannel::ECC_Visibility, 
-		ECollisionResponse::ECR_Block);
+	CollisionBox->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
 
 	AreaSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AreaSphere"));
 	AreaSphere->SetupAttachment(GetRootComponent());
-
-	PickupWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("PickupWidget"));
-	PickupWidget->SetupAttachment(GetRootComponent());
+	// Only used for its radius, nearby characters are found through UItemProximitySubsystem
+	AreaSphere->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	AreaSphere->SetGenerateOverlapEvents(false);
 }
 
 // Init
 void AItem::BeginPlay()
 {
 	Super::BeginPlay();
-	
-	// pickup
-	HideUI();
 
-	// detect area
-	AreaSphere->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnSphereOverlap);
-	AreaSphere->OnComponentEndOverlap.AddDynamic(this, &AItem::OnSphereEndOverlap);
 	// auto pickup
 	CollisionBox->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnBoxOverlap);
 	CollisionBox->OnComponentEndOverlap.AddDynamic(this, &AItem::OnBoxEndOverlap);
 
 	SetItemProperties(ItemState);
+
+	if (HasAuthority() && !CVarShooterItemDormancy.GetValueOnGameThread())
+	{
+		SetNetDormancy(DORM_Awake);
+	}
+	else if (HasAuthority() && !IsNetStartupActor() && IsResting(ItemState))
+	{
+		// DORM_Initial only holds for items placed in the level. Spawned ones (stress items, promoted
+		// proxies) would start awake and stay so until their first state change
+		SetNetDormancy(DORM_DormantAll);
+	}
+
+	UpdateProximityRegistration();
+	UpdateTickRegistration();
+
+	// Far from every player this item becomes an instance of ProxyMesh
+	if (UItemProxySubsystem* ProxySubsystem = GetWorld()->GetSubsystem<UItemProxySubsystem>())
+	{
+		ProxySubsystem->RegisterItem(this);
+	}
 }
 
-// Called every frame
-void AItem::Tick(float DeltaTime)
+void AItem::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
-	Super::Tick(DeltaTime);
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AItem, ItemState, Params);
 }
 
-void AItem::ShowUI()
+void AItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	if (GetPickupWidget())
+	if (UItemProximitySubsystem* ProximitySubsystem = GetWorld()->GetSubsystem<UItemProximitySubsystem>())
 	{
-		GetPickupWidget()->SetVisibility(true);
+		ProximitySubsystem->RemoveItem(this);
 	}
+	if (UItemTickSubsystem* TickSubsystem = GetWorld()->GetSubsystem<UItemTickSubsystem>())
+	{
+		TickSubsystem->UnregisterItem(this);
+	}
+	if (UItemProxySubsystem* ProxySubsystem = GetWorld()->GetSubsystem<UItemProxySubsystem>())
+	{
+		ProxySubsystem->UnregisterItem(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
-void AItem::HideUI()
+void AItem::TickItem(float DeltaTime)
 {
-	if (GetPickupWidget())
-	{
-		GetPickupWidget()->SetVisibility(false);
-	}
 }
 
-void AItem::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+bool AItem::ShouldSimulateFalling() const
 {
-	if (ItemState == EItemState::EIS_Idle)
-	{
-		if (OtherActor)
-		{
-			AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(OtherActor);
-			if (ShooterCharacter)
-			{
-				ShooterCharacter->AddOverlappedItemCount(1);
-				SetItemState(EItemState::EIS_Pickup);
-			}
-		}
-	}
+	return true;
 }
 
-void AItem::OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+void AItem::SerializeProxyState(FArchive& Ar)
 {
-	if (ItemState == EItemState::EIS_Pickup)
-	{
-		if (OtherActor)
-		{
-			AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(OtherActor);
-			if (ShooterCharacter)
-			{
-				ShooterCharacter->AddOverlappedItemCount(-1);
-				GetPickupWidget()->SetVisibility(false);
-				SetItemState(EItemState::EIS_Idle);
-			}
-		}
-	}
+	Ar << ItemCount;
 }
 
 void AItem::OnBoxOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	// Pickups are the server's call, clients get the equip through replication
+	if (!HasAuthority()) return;
+
 	if (ItemState == EItemState::EIS_Pickup)
 	{
 		if (OtherActor)
@@ -127,76 +162,146 @@ void AItem::OnBoxEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* Ot
 
 void AItem::SetItemProperties(EItemState State)
 {
-	switch (State)
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterSetItemProperties);
+
+	FItemStateCollision Collision{ GetItemStateCollision(State) };
+	if (!Collision.bApply) return;
+
+	if (Collision.bSimulatePhysics && !ShouldSimulateFalling())
+	{
+		// No rigid body at all
+		Collision.MeshProfile = UCollisionProfile::NoCollision_ProfileName;
+		Collision.bSimulatePhysics = false;
+	}
+
+	// Physics off before the profile swap, on after it, so the body never simulates without collision
+	if (!Collision.bSimulatePhysics)
+	{
+		SetMeshSimulatePhysics(false);
+	}
+
+	ApplyCollisionProfile(ItemMesh, Collision.MeshProfile);
+	ApplyCollisionProfile(CollisionBox, Collision.BoxProfile);
+
+	if (Collision.bSimulatePhysics)
+	{
+		SetMeshSimulatePhysics(true);
+	}
+	else
 	{
-	case EItemState::EIS_Idle:
-		PickupWidget->SetVisibility(false);
-		// Set mesh properties
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetEnableGravity(false);
-		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-		// CollisionBox ignore
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
-	case EItemState::EIS_Pickup:
-		// Set mesh properties
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetEnableGravity(false);
-		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-		// Set CollisionBox properties
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-		CollisionBox->SetCollisionResponseToChannel(
-			ECollisionChannel::ECC_Visibility,
-			ECollisionResponse::ECR_Block);
-		break;
-	case EItemState::EIS_Equipped:
-		PickupWidget->SetVisibility(false);
-		// Set mesh properties
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetEnableGravity(false);
 		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set CollisionBox properties
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
-	case EItemState::EIS_Falling:
-		// Set mesh properties
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-		ItemMesh->SetSimulatePhysics(true);
-		ItemMesh->SetEnableGravity(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionResponseToChannel(
-			ECollisionChannel::ECC_WorldStatic,
-			ECollisionResponse::ECR_Block);
-		// Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set CollisionBox properties
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
+	}
+}
+
+const AItem::FItemStateCollision& AItem::GetItemStateCollision(EItemState State)
+{
+	// Built once, indexed by EItemState. Interping and picked up items keep their collision
+	static const FItemStateCollision Table[(int32)EItemState::EIS_MAX] =
+	{
+		/* EIS_Idle */ { true, UCollisionProfile::NoCollision_ProfileName, UCollisionProfile::NoCollision_ProfileName, false },
+		/* EIS_Pickup */ { true, UCollisionProfile::NoCollision_ProfileName, PickupBoxProfileName, false },
+		/* EIS_EquipInterping */ { false, NAME_None, NAME_None, false },
+		/* EIS_PickedUp */ { false, NAME_None, NAME_None, false },
+		/* EIS_Equipped */ { true, UCollisionProfile::NoCollision_ProfileName, UCollisionProfile::NoCollision_ProfileName, false },
+		/* EIS_Falling */ { true, FallingMeshProfileName, UCollisionProfile::NoCollision_ProfileName, true },
+	};
+
+	check((int32)State < (int32)EItemState::EIS_MAX);
+	return Table[(int32)State];
+}
+
+void AItem::ApplyCollisionProfile(UPrimitiveComponent* Component, FName ProfileName)
+{
+	// Every swap recreates the physics state, skip components already there
+	if (Component == nullptr || Component->GetCollisionProfileName() == ProfileName) return;
+
+	Component->SetCollisionProfileName(ProfileName);
+}
+
+void AItem::SetMeshSimulatePhysics(bool bSimulate)
+{
+	if (ItemMesh->IsSimulatingPhysics() != bSimulate)
+	{
+		ItemMesh->SetSimulatePhysics(bSimulate);
+	}
+	if (ItemMesh->IsGravityEnabled() != bSimulate)
+	{
+		ItemMesh->SetEnableGravity(bSimulate);
 	}
 }
 
 void AItem::SetItemState(EItemState State)
 {
+	SHOOTER_INC_COUNTER(STAT_ShooterItemStateChanges);
+	FShooterFrameTimingScope FrameTiming(GetWorld(), EShooterFrameTiming::ItemStateChange);
+
+	const EItemState OldState{ ItemState };
 	ItemState = State;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AItem, ItemState, this);
 	SetItemProperties(State);
+	UpdateProximityRegistration();
+	UpdateTickRegistration();
+	UpdateNetDormancy(OldState);
+}
+
+void AItem::OnRep_ItemState()
+{
+	SetItemProperties(ItemState);
+	UpdateProximityRegistration();
+	UpdateTickRegistration();
+}
+
+void AItem::UpdateNetDormancy(EItemState OldState)
+{
+	if (!HasAuthority() || GetNetMode() == NM_Standalone) return;
+	if (!CVarShooterItemDormancy.GetValueOnGameThread()) return;
+
+	// Pickup is per character, every machine works it out from its own characters
+	if (IsResting(OldState) && IsResting(ItemState)) return;
+
+	if (IsResting(ItemState))
+	{
+		// The channel closes once the final state and transform are acked
+		SetNetDormancy(DORM_DormantAll);
+	}
+	else
+	{
+		SetNetDormancy(DORM_Awake);
+		ForceNetUpdate();
+	}
+}
+
+void AItem::UpdateProximityRegistration()
+{
+	UItemProximitySubsystem* ProximitySubsystem = GetWorld()->GetSubsystem<UItemProximitySubsystem>();
+	if (ProximitySubsystem == nullptr) return;
+
+	if (ItemState == EItemState::EIS_Idle || ItemState == EItemState::EIS_Pickup)
+	{
+		ProximitySubsystem->UpdateItem(this);
+	}
+	else
+	{
+		ProximitySubsystem->RemoveItem(this);
+	}
+}
+
+void AItem::UpdateTickRegistration()
+{
+	UItemTickSubsystem* TickSubsystem = GetWorld()->GetSubsystem<UItemTickSubsystem>();
+	if (TickSubsystem == nullptr) return;
+
+	if (ItemState == EItemState::EIS_Falling || ItemState == EItemState::EIS_EquipInterping)
+	{
+		TickSubsystem->RegisterItem(this);
+	}
+	else
+	{
+		TickSubsystem->UnregisterItem(this);
+	}
+}
+
+float AItem::GetPickupRadius() const
+{
+	return AreaSphere ? AreaSphere->GetScaledSphereRadius() : 0.f;
 }
@@ -32,23 +32,12 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-	// pick up
-	UFUNCTION()
-	void OnSphereOverlap(
-		UPrimitiveComponent* OverlappedComponent,
-		AActor* OtherActor,
-		UPrimitiveComponent* OtherComp,
-		int32 OtherBodyIndex,
-		bool bFromSweep,
-		const FHitResult& SweepResult);
+public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
-	UFUNCTION()
-	void OnSphereEndOverlap(
-		UPrimitiveComponent* OverlappedComponent,
-		AActor* OtherActor,
-		UPrimitiveComponent* OtherComp,
-		int32 OtherBodyIndex);
+protected:
 
 	// auto pick up
 	UFUNCTION()
@@ -69,9 +58,48 @@ protected:
 
 	void SetItemProperties(EItemState State);
 
+	/** Collision profiles, see [/Script/Engine.CollisionProfile] in DefaultEngine.ini */
+	static const FName PickupBoxProfileName;
+	static const FName FallingMeshProfileName;
+
+	/** Collision of ItemMesh and CollisionBox in one state */
+	struct FItemStateCollision
+	{
+		/** False leaves the components as they are */
+		bool bApply;
+		FName MeshProfile;
+		FName BoxProfile;
+		bool bSimulatePhysics;
+	};
+	static const FItemStateCollision& GetItemStateCollision(EItemState State);
+
+	/** Swaps the profile of Component unless it already uses it */
+	static void ApplyCollisionProfile(UPrimitiveComponent* Component, FName ProfileName);
+
+	/** Physics and gravity of ItemMesh, only touched when they change */
+	void SetMeshSimulatePhysics(bool bSimulate);
+
+	/** Keeps the item in the proximity grid while it can be picked up */
+	void UpdateProximityRegistration();
+
+	/** Registers with UItemTickSubsystem while the state needs per-frame work */
+	void UpdateTickRegistration();
+
+	/** Dormant while resting (Idle / Pickup) so the server skips the item, awake otherwise */
+	void UpdateNetDormancy(EItemState OldState);
+
+	UFUNCTION()
+	void OnRep_ItemState();
+
 public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
+	/** Called every frame by UItemTickSubsystem while falling or equip interping */
+	virtual void TickItem(float DeltaTime);
+
+	/** False keeps ItemMesh kinematic and collision free while Falling, the item moves itself */
+	virtual bool ShouldSimulateFalling() const;
+
+	/** What a proxy must remember to respawn this item as it was, see UItemProxySubsystem. Object references are saved as paths */
+	virtual void SerializeProxyState(FArchive& Ar);
 
 #pragma region Private
 	private:
@@ -79,14 +107,14 @@ public:
 	USkeletalMeshComponent* ItemMesh;
 
 
-	// pick up
+	/** Where the local player's pickup widget is drawn, from the actor location in world space */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
-	class UWidgetComponent* PickupWidget;
+	FVector PickupWidgetOffset;
 	
 	// collide with body to pickup
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	class UBoxComponent* CollisionBox;
-	// collide with body to begin crosshair trace
+	// radius in which characters begin crosshair trace, no collision, see UItemProximitySubsystem
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	class USphereComponent* AreaSphere;
 
@@ -96,21 +124,38 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	int32 ItemCount;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_ItemState, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	EItemState ItemState;
 
+	/** Index in UItemTickSubsystem, INDEX_NONE when not ticking */
+	int32 ItemTickIndex;
+	friend class UItemTickSubsystem;
+
+	/** Last UItemProximitySubsystem query that found this item */
+	uint32 ProximityQueryId;
+	friend class UItemProximitySubsystem;
+
+	/** Static stand-in drawn while the item is far from every player, not proxied if empty */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	class UStaticMesh* ProxyMesh;
+
+	/** Index in UItemProxySubsystem, INDEX_NONE when not registered */
+	int32 ItemProxyIndex;
+	friend class UItemProxySubsystem;
+
 #pragma endregion
 
 #pragma region Public
 public:
-	FORCEINLINE UWidgetComponent* GetPickupWidget() const { return PickupWidget; }
+	FORCEINLINE FVector GetPickupWidgetLocation() const { return GetActorLocation() + PickupWidgetOffset; }
 	FORCEINLINE USphereComponent* GetAreaSphere() const { return AreaSphere; }
+	float GetPickupRadius() const;
 	FORCEINLINE UBoxComponent* GetCollisionBox() const { return CollisionBox; }
 	FORCEINLINE EItemState GetItemState() const { return ItemState; }
 	void SetItemState(EItemState State);
 	FORCEINLINE USkeletalMeshComponent* GetItemMesh() const { return ItemMesh; }
-
-	void ShowUI();
-	void HideUI();
+	FORCEINLINE const FString& GetItemName() const { return ItemName; }
+	FORCEINLINE int32 GetItemCount() const { return ItemCount; }
+	FORCEINLINE UStaticMesh* GetProxyMesh() const { return ProxyMesh; }
 #pragma endregion
 };
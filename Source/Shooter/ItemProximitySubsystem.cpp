@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemProximitySubsystem.h"
+#include "Item.h"
+
+UItemProximitySubsystem::UItemProximitySubsystem() :
+	CellSize(500.f),
+	MaxItemRadius(0.f),
+	LastQueryId(0)
+{
+}
+
+void UItemProximitySubsystem::UpdateItem(AItem* Item)
+{
+	if (Item == nullptr) return;
+
+	const FVector Location{ Item->GetActorLocation() };
+	const float Radius{ Item->GetPickupRadius() };
+	const FIntVector Cell{ GetCell(Location) };
+	MaxItemRadius = FMath::Max(MaxItemRadius, Radius);
+
+	// Still in the same cell, refresh the cached entry
+	if (const FIntVector* OldCell = ItemCells.Find(Item))
+	{
+		if (*OldCell == Cell)
+		{
+			for (FItemProximityEntry& Entry : Cells.FindChecked(Cell))
+			{
+				if (Entry.Item == Item)
+				{
+					Entry.Location = Location;
+					Entry.Radius = Radius;
+					return;
+				}
+			}
+		}
+		RemoveItem(Item);
+	}
+
+	Cells.FindOrAdd(Cell).Add({ Item, Location, Radius });
+	ItemCells.Add(Item, Cell);
+}
+
+void UItemProximitySubsystem::RemoveItem(AItem* Item)
+{
+	FIntVector Cell;
+	if (!ItemCells.RemoveAndCopyValue(Item, Cell)) return;
+
+	TArray<FItemProximityEntry>* Entries = Cells.Find(Cell);
+	if (Entries == nullptr) return;
+
+	const int32 Index = Entries->IndexOfByPredicate([Item](const FItemProximityEntry& Entry)
+	{
+		return Entry.Item == Item;
+	});
+	if (Index != INDEX_NONE)
+	{
+		Entries->RemoveAtSwap(Index, 1, false);
+	}
+	if (Entries->Num() == 0)
+	{
+		Cells.Remove(Cell);
+	}
+}
+
+uint32 UItemProximitySubsystem::QueryItems(const FVector& Location, float Radius, TArray<AItem*>& OutItems)
+{
+	OutItems.Reset();
+
+	// Never 0, which items start with
+	LastQueryId = LastQueryId == MAX_uint32 ? 1 : LastQueryId + 1;
+	if (Cells.Num() == 0) return LastQueryId;
+
+	const FVector Extent{ FVector(Radius + MaxItemRadius) };
+	const FIntVector MinCell{ GetCell(Location - Extent) };
+	const FIntVector MaxCell{ GetCell(Location + Extent) };
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const TArray<FItemProximityEntry>* Entries = Cells.Find(FIntVector(X, Y, Z));
+				if (Entries == nullptr) continue;
+
+				for (const FItemProximityEntry& Entry : *Entries)
+				{
+					const float Range{ Radius + Entry.Radius };
+					if (FVector::DistSquared(Location, Entry.Location) <= Range * Range)
+					{
+						Entry.Item->ProximityQueryId = LastQueryId;
+						OutItems.Add(Entry.Item);
+					}
+				}
+			}
+		}
+	}
+
+	return LastQueryId;
+}
+
+bool UItemProximitySubsystem::WasFoundByQuery(const AItem* Item, uint32 QueryId)
+{
+	return Item->ProximityQueryId == QueryId;
+}
+
+FIntVector UItemProximitySubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemProximitySubsystem.generated.h"
+
+class AItem;
+
+/** Cached position and pickup radius of an item in the grid */
+struct FItemProximityEntry
+{
+	AItem* Item;
+	FVector Location;
+	float Radius;
+};
+
+/**
+ * Uniform grid of the items that can be picked up (Idle / Pickup).
+ * Items are only re-inserted when their state changes, so idle loot costs nothing per frame,
+ * and characters query it instead of relying on per-item overlap spheres.
+ */
+UCLASS()
+class SHOOTER_API UItemProximitySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UItemProximitySubsystem();
+
+	/** Adds Item, or moves it to the cell of its current location */
+	void UpdateItem(AItem* Item);
+	void RemoveItem(AItem* Item);
+
+	/**
+	 * Items whose pickup radius overlaps the sphere at Location. Returns the query's id, which every
+	 * found item keeps until the next query finds it, see WasFoundByQuery.
+	 */
+	uint32 QueryItems(const FVector& Location, float Radius, TArray<AItem*>& OutItems);
+
+	/** True if Item was in the result of the query that returned QueryId, constant time */
+	static bool WasFoundByQuery(const AItem* Item, uint32 QueryId);
+
+	FORCEINLINE int32 GetNumItems() const { return ItemCells.Num(); }
+
+private:
+	FIntVector GetCell(const FVector& Location) const;
+
+	TMap<FIntVector, TArray<FItemProximityEntry>> Cells;
+	TMap<AItem*, FIntVector> ItemCells;
+
+	/** Edge length of a grid cell */
+	float CellSize;
+
+	/** Largest pickup radius registered, the query range is extended by it */
+	float MaxItemRadius;
+
+	uint32 LastQueryId;
+};
@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemProxyActor.h"
+#include "Shooter.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Net/UnrealNetwork.h"
+
+void FItemProxyInstance::PostReplicatedAdd(const FItemProxyInstanceArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->RefreshInstance(*this);
+	}
+}
+
+void FItemProxyInstance::PostReplicatedChange(const FItemProxyInstanceArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->RefreshInstance(*this);
+	}
+}
+
+void FItemProxyInstance::PreReplicatedRemove(const FItemProxyInstanceArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HideInstance(*this);
+	}
+}
+
+AItemProxyActor::AItemProxyActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	// Every client sees every proxy, they are cheap and only change when items are demoted or promoted
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	NetUpdateFrequency = 4.f;
+
+	// The components sit at the origin, so local and world space are the same
+	SetRootComponent(CreateDefaultSubobject<USceneComponent>(TEXT("Root")));
+}
+
+void AItemProxyActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AItemProxyActor, Slots);
+}
+
+void AItemProxyActor::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	Slots.Owner = this;
+}
+
+void AItemProxyActor::SetInstance(int32 Slot, UStaticMesh* Mesh, const FTransform& Transform)
+{
+	if (Slot >= Slots.Instances.Num())
+	{
+		Slots.Instances.SetNum(Slot + 1);
+	}
+
+	FItemProxyInstance& Instance = Slots.Instances[Slot];
+	Instance.Mesh = Mesh;
+	Instance.Location = Transform.GetLocation();
+	Instance.Rotation = Transform.Rotator();
+	Instance.Scale = Transform.GetScale3D();
+	Slots.MarkItemDirty(Instance);
+
+	RefreshInstance(Instance);
+}
+
+void AItemProxyActor::ClearInstance(int32 Slot)
+{
+	if (!Slots.Instances.IsValidIndex(Slot)) return;
+
+	FItemProxyInstance& Instance = Slots.Instances[Slot];
+	Instance.Mesh = nullptr;
+	Slots.MarkItemDirty(Instance);
+
+	HideInstance(Instance);
+}
+
+void AItemProxyActor::RefreshInstance(FItemProxyInstance& Instance)
+{
+	HideInstance(Instance);
+
+	// Nothing to look at on a dedicated server
+	if (Instance.Mesh == nullptr || GetNetMode() == NM_DedicatedServer) return;
+
+	FItemProxyMeshInstances& Instances = MeshInstances.FindOrAdd(Instance.Mesh);
+	if (Instances.Component == nullptr)
+	{
+		// Purely visual, the item actor is back before anyone can touch or trace it
+		Instances.Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(this);
+		Instances.Component->SetStaticMesh(Instance.Mesh);
+		Instances.Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Instances.Component->SetGenerateOverlapEvents(false);
+		Instances.Component->SetupAttachment(GetRootComponent());
+		Instances.Component->RegisterComponent();
+		AddInstanceComponent(Instances.Component);
+	}
+
+	const FTransform Transform(Instance.Rotation, Instance.Location, Instance.Scale);
+	Instance.ShownMesh = Instance.Mesh;
+	if (Instances.FreeInstances.Num() > 0)
+	{
+		Instance.ShownInstance = Instances.FreeInstances.Pop(false);
+		Instances.Component->UpdateInstanceTransform(Instance.ShownInstance, Transform, false, true, true);
+	}
+	else
+	{
+		Instance.ShownInstance = Instances.Component->AddInstance(Transform);
+	}
+}
+
+void AItemProxyActor::HideInstance(FItemProxyInstance& Instance)
+{
+	FItemProxyMeshInstances* Instances = MeshInstances.Find(Instance.ShownMesh);
+	if (Instances && Instances->Component && Instance.ShownInstance != INDEX_NONE)
+	{
+		// Hidden rather than removed, RemoveInstance would reorder instances and rebuild the tree
+		const FTransform Hidden(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+		Instances->Component->UpdateInstanceTransform(Instance.ShownInstance, Hidden, false, true, true);
+		Instances->FreeInstances.Add(Instance.ShownInstance);
+	}
+
+	Instance.ShownMesh = nullptr;
+	Instance.ShownInstance = INDEX_NONE;
+}
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "ItemProxyActor.generated.h"
+
+class AItemProxyActor;
+class UStaticMesh;
+class UHierarchicalInstancedStaticMeshComponent;
+
+/** One proxy slot, Mesh is null while the slot is free */
+USTRUCT()
+struct FItemProxyInstance : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UStaticMesh* Mesh = nullptr;
+
+	UPROPERTY()
+	FVector_NetQuantize10 Location;
+
+	UPROPERTY()
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	UPROPERTY()
+	FVector_NetQuantize100 Scale = FVector::OneVector;
+
+	/** Mesh and HISM instance shown on this machine, kept alive by AItemProxyActor::MeshInstances */
+	UStaticMesh* ShownMesh = nullptr;
+	int32 ShownInstance = INDEX_NONE;
+
+	void PostReplicatedAdd(const struct FItemProxyInstanceArray& InArraySerializer);
+	void PostReplicatedChange(const struct FItemProxyInstanceArray& InArraySerializer);
+	void PreReplicatedRemove(const struct FItemProxyInstanceArray& InArraySerializer);
+};
+
+/** Proxy slots of UItemProxySubsystem, only the slots that changed are sent */
+USTRUCT()
+struct FItemProxyInstanceArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FItemProxyInstance> Instances;
+
+	UPROPERTY(NotReplicated)
+	AItemProxyActor* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FItemProxyInstance, FItemProxyInstanceArray>(Instances, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FItemProxyInstanceArray> : public TStructOpsTypeTraitsBase2<FItemProxyInstanceArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/** Every proxy instance of one mesh */
+USTRUCT()
+struct FItemProxyMeshInstances
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UHierarchicalInstancedStaticMeshComponent* Component = nullptr;
+
+	/** Zero scaled instances, reused before adding new ones so the HISM tree is never rebuilt for a removal */
+	TArray<int32> FreeInstances;
+};
+
+/**
+ * Shows the item proxies of UItemProxySubsystem, one hierarchical instanced static mesh per item mesh.
+ * Spawned by the server (or standalone game), which fills the slots; clients receive the slots and
+ * build the same instances. A dedicated server keeps the slots but no components.
+ */
+UCLASS(NotPlaceable, Transient)
+class SHOOTER_API AItemProxyActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AItemProxyActor();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PostInitializeComponents() override;
+
+	/** Shows Mesh at Transform in Slot, replacing what the slot showed */
+	void SetInstance(int32 Slot, UStaticMesh* Mesh, const FTransform& Transform);
+
+	/** Hides the slot, it can be set again */
+	void ClearInstance(int32 Slot);
+
+private:
+	friend struct FItemProxyInstance;
+
+	/** Brings the HISM instance of Instance in line with its replicated mesh and transform */
+	void RefreshInstance(FItemProxyInstance& Instance);
+	void HideInstance(FItemProxyInstance& Instance);
+
+	UPROPERTY(Replicated)
+	FItemProxyInstanceArray Slots;
+
+	UPROPERTY()
+	TMap<UStaticMesh*, FItemProxyMeshInstances> MeshInstances;
+};
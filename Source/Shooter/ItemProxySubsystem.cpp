@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemProxySubsystem.h"
+#include "Shooter.h"
+#include "Item.h"
+#include "ItemProxyActor.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+
+UItemProxySubsystem::UItemProxySubsystem() :
+	PromoteRadius(1500.f),
+	DemoteRadius(2000.f),
+	UpdateInterval(0.25f),
+	TimeUntilUpdate(0.f),
+	NumProxies(0),
+	ProxyActor(nullptr)
+{
+}
+
+void UItemProxySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate > 0.f) return;
+	TimeUntilUpdate = UpdateInterval;
+
+	if (Items.Num() == 0 && NumProxies == 0) return;
+
+	// Nobody to measure against yet (loading, spectating), leave everything as it is
+	GatherPlayerLocations();
+	if (PlayerLocations.Num() == 0) return;
+
+	PromoteNearbyProxies();
+	DemoteIdleItems();
+
+	CSV_CUSTOM_STAT(Shooter, ItemProxies, NumProxies, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Shooter, ItemProxyActors, Items.Num(), ECsvCustomStatOp::Set);
+}
+
+TStatId UItemProxySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemProxySubsystem, STATGROUP_Tickables);
+}
+
+void UItemProxySubsystem::RegisterItem(AItem* Item)
+{
+	if (Item == nullptr || Item->ItemProxyIndex != INDEX_NONE) return;
+
+	// Only the server demotes, clients follow the destroyed actor and the replicated proxy
+	if (!Item->HasAuthority()) return;
+	if (Item->GetProxyMesh() == nullptr) return;
+
+	Item->ItemProxyIndex = Items.Add(Item);
+}
+
+void UItemProxySubsystem::UnregisterItem(AItem* Item)
+{
+	if (Item == nullptr || Item->ItemProxyIndex == INDEX_NONE) return;
+
+	const int32 Index = Item->ItemProxyIndex;
+	Items.RemoveAtSwap(Index, 1, false);
+	if (Items.IsValidIndex(Index) && Items[Index])
+	{
+		Items[Index]->ItemProxyIndex = Index;
+	}
+	Item->ItemProxyIndex = INDEX_NONE;
+}
+
+void UItemProxySubsystem::GatherPlayerLocations()
+{
+	PlayerLocations.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController && PlayerController->GetPawn())
+		{
+			PlayerLocations.Add(PlayerController->GetPawn()->GetActorLocation());
+		}
+	}
+}
+
+bool UItemProxySubsystem::IsPlayerWithin(const FVector& Location, float Radius) const
+{
+	const float RadiusSquared = FMath::Square(Radius);
+	for (const FVector& PlayerLocation : PlayerLocations)
+	{
+		if (FVector::DistSquared(PlayerLocation, Location) <= RadiusSquared) return true;
+	}
+	return false;
+}
+
+void UItemProxySubsystem::PromoteNearbyProxies()
+{
+	if (NumProxies == 0) return;
+
+	// Collected first, promoting edits the cells
+	TArray<int32, TInlineAllocator<16>> ToPromote;
+	const float PromoteRadiusSquared = FMath::Square(PromoteRadius);
+
+	for (const FVector& PlayerLocation : PlayerLocations)
+	{
+		// Cells are PromoteRadius wide, the 3x3 block around the player covers the radius
+		const FIntPoint PlayerCell = GetCell(PlayerLocation);
+		for (int32 Y = -1; Y <= 1; Y++)
+		{
+			for (int32 X = -1; X <= 1; X++)
+			{
+				const TArray<int32>* Cell = ProxyCells.Find(PlayerCell + FIntPoint(X, Y));
+				if (Cell == nullptr) continue;
+
+				for (const int32 ProxyIndex : *Cell)
+				{
+					if (FVector::DistSquared(Proxies[ProxyIndex].ActorTransform.GetLocation(), PlayerLocation) <= PromoteRadiusSquared)
+					{
+						ToPromote.AddUnique(ProxyIndex);
+					}
+				}
+			}
+		}
+	}
+
+	for (const int32 ProxyIndex : ToPromote)
+	{
+		PromoteProxy(ProxyIndex);
+	}
+}
+
+void UItemProxySubsystem::DemoteIdleItems()
+{
+	// Backwards, demoting destroys the item which swaps it out of Items
+	for (int32 Index = Items.Num() - 1; Index >= 0; --Index)
+	{
+		AItem* Item = Items[Index];
+		if (!IsValid(Item)) continue;
+
+		// Pickup means someone is in range, anything else means it's moving or held
+		if (Item->GetItemState() != EItemState::EIS_Idle) continue;
+		if (IsPlayerWithin(Item->GetActorLocation(), DemoteRadius)) continue;
+
+		DemoteItem(Item);
+	}
+}
+
+void UItemProxySubsystem::PromoteProxy(int32 ProxyIndex)
+{
+	// Copied out, spawning may register items
+	const FItemProxy Proxy = MoveTemp(Proxies[ProxyIndex]);
+	Proxies[ProxyIndex] = FItemProxy();
+	FreeProxies.Add(ProxyIndex);
+	NumProxies--;
+
+	if (TArray<int32>* Cell = ProxyCells.Find(Proxy.Cell))
+	{
+		Cell->RemoveSingleSwap(ProxyIndex, false);
+	}
+	if (ProxyActor)
+	{
+		ProxyActor->ClearInstance(ProxyIndex);
+	}
+
+	if (Proxy.ItemClass == nullptr) return;
+
+	AItem* Item = GetWorld()->SpawnActorDeferred<AItem>(
+		Proxy.ItemClass,
+		Proxy.ActorTransform,
+		nullptr,
+		nullptr,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Item == nullptr) return;
+
+	FMemoryReader MemoryReader(Proxy.State);
+	FObjectAndNameAsStringProxyArchive Reader(MemoryReader, true);
+	Item->SerializeProxyState(Reader);
+	Item->FinishSpawning(Proxy.ActorTransform);
+}
+
+void UItemProxySubsystem::DemoteItem(AItem* Item)
+{
+	UStaticMesh* Mesh = Item->GetProxyMesh();
+
+	const int32 ProxyIndex = FreeProxies.Num() > 0 ? FreeProxies.Pop(false) : Proxies.AddDefaulted();
+	FItemProxy& Proxy = Proxies[ProxyIndex];
+	Proxy.ItemClass = Item->GetClass();
+	Proxy.Mesh = Mesh;
+	Proxy.ActorTransform = Item->GetActorTransform();
+	Proxy.Cell = GetCell(Proxy.ActorTransform.GetLocation());
+
+	if (ProxyActor == nullptr)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Name = TEXT("ItemProxies");
+		ProxyActor = GetWorld()->SpawnActor<AItemProxyActor>(SpawnParams);
+	}
+	if (ProxyActor)
+	{
+		ProxyActor->SetInstance(ProxyIndex, Mesh, Item->GetItemMesh()->GetComponentTransform());
+	}
+
+	// Object references as paths, items may point at data assets
+	FMemoryWriter MemoryWriter(Proxy.State);
+	FObjectAndNameAsStringProxyArchive Writer(MemoryWriter, false);
+	Item->SerializeProxyState(Writer);
+
+	ProxyCells.FindOrAdd(Proxy.Cell).Add(ProxyIndex);
+	NumProxies++;
+
+	Item->Destroy();
+}
+
+FIntPoint UItemProxySubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(
+		FMath::FloorToInt(Location.X / PromoteRadius),
+		FMath::FloorToInt(Location.Y / PromoteRadius));
+}
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemProxySubsystem.generated.h"
+
+class AItem;
+class AItemProxyActor;
+class UStaticMesh;
+
+/** An idle item with no player nearby, kept as one instance of its class' ProxyMesh */
+USTRUCT()
+struct FItemProxy
+{
+	GENERATED_BODY()
+
+	/** Class spawned when the proxy is promoted, nullptr for a free slot */
+	UPROPERTY()
+	TSubclassOf<AItem> ItemClass;
+
+	UPROPERTY()
+	UStaticMesh* Mesh = nullptr;
+
+	FTransform ActorTransform;
+
+	/** Cell of ProxyCells the proxy is listed in */
+	FIntPoint Cell = FIntPoint::ZeroValue;
+
+	/** AItem::SerializeProxyState */
+	TArray<uint8> State;
+};
+
+/**
+ * Keeps idle items far from every player as instances of one hierarchical instanced static mesh
+ * per item mesh instead of full actors. An item is demoted to a proxy once it is idle with no
+ * player within DemoteRadius, and promoted back to its actor when a player comes within
+ * PromoteRadius, so actor and component counts follow the players rather than the loot.
+ * Runs where items are authoritative; clients see the proxies through the replicated AItemProxyActor.
+ */
+UCLASS()
+class SHOOTER_API UItemProxySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UItemProxySubsystem();
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Items with a ProxyMesh become demotion candidates */
+	void RegisterItem(AItem* Item);
+	void UnregisterItem(AItem* Item);
+
+	FORCEINLINE int32 GetNumProxies() const { return NumProxies; }
+	FORCEINLINE int32 GetNumItems() const { return Items.Num(); }
+
+private:
+	void GatherPlayerLocations();
+	bool IsPlayerWithin(const FVector& Location, float Radius) const;
+
+	void PromoteNearbyProxies();
+	void DemoteIdleItems();
+
+	void PromoteProxy(int32 ProxyIndex);
+	void DemoteItem(AItem* Item);
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Proxies are promoted when a player is this close */
+	UPROPERTY(EditAnywhere, Category = "Item Proxies")
+	float PromoteRadius;
+
+	/** Idle items with no player this close are demoted, larger than PromoteRadius so items don't flip */
+	UPROPERTY(EditAnywhere, Category = "Item Proxies")
+	float DemoteRadius;
+
+	/** Seconds between two updates */
+	UPROPERTY(EditAnywhere, Category = "Item Proxies")
+	float UpdateInterval;
+
+	float TimeUntilUpdate;
+
+	/** Item actors that can be demoted, each stores its index, see AItem::ItemProxyIndex */
+	UPROPERTY()
+	TArray<AItem*> Items;
+
+	/** Slots of freed proxies are reused, a proxy's slot in ProxyActor has the same index */
+	UPROPERTY()
+	TArray<FItemProxy> Proxies;
+	TArray<int32> FreeProxies;
+	int32 NumProxies;
+
+	/** Proxy indices by PromoteRadius sized cell */
+	TMap<FIntPoint, TArray<int32>> ProxyCells;
+
+	/** Shows the proxies here and on clients, spawned with the first one */
+	UPROPERTY()
+	AItemProxyActor* ProxyActor;
+
+	/** Pawns of every player controller, refreshed each update */
+	TArray<FVector> PlayerLocations;
+};
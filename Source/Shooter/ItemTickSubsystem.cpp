@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemTickSubsystem.h"
+#include "Item.h"
+
+void UItemTickSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Items may unregister themselves (or others) while ticking. Those slots are only nulled
+	// until the loop is done, so nothing shifts under the index and no item ticks twice
+	bTickingItems = true;
+	const int32 NumItems = TickingItems.Num();
+	for (int32 Index = 0; Index < NumItems; ++Index)
+	{
+		AItem* Item = TickingItems[Index];
+		if (IsValid(Item))
+		{
+			Item->TickItem(DeltaTime);
+		}
+		else
+		{
+			TickingItems[Index] = nullptr;
+		}
+	}
+	bTickingItems = false;
+
+	// Compact in place, items registered during the loop were appended and keep their order
+	int32 NumKept = 0;
+	for (int32 Index = 0; Index < TickingItems.Num(); ++Index)
+	{
+		AItem* Item = TickingItems[Index];
+		if (Item == nullptr) continue;
+
+		Item->ItemTickIndex = NumKept;
+		TickingItems[NumKept++] = Item;
+	}
+	TickingItems.SetNum(NumKept, false);
+}
+
+TStatId UItemTickSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemTickSubsystem, STATGROUP_Tickables);
+}
+
+void UItemTickSubsystem::RegisterItem(AItem* Item)
+{
+	if (Item == nullptr || Item->ItemTickIndex != INDEX_NONE) return;
+
+	Item->ItemTickIndex = TickingItems.Add(Item);
+}
+
+void UItemTickSubsystem::UnregisterItem(AItem* Item)
+{
+	if (Item == nullptr) return;
+
+	const int32 Index = Item->ItemTickIndex;
+	if (!TickingItems.IsValidIndex(Index) || TickingItems[Index] != Item) return;
+
+	if (bTickingItems)
+	{
+		// Compacted at the end of Tick
+		TickingItems[Index] = nullptr;
+	}
+	else
+	{
+		TickingItems.RemoveAtSwap(Index, 1, false);
+		if (TickingItems.IsValidIndex(Index) && TickingItems[Index])
+		{
+			TickingItems[Index]->ItemTickIndex = Index;
+		}
+	}
+	Item->ItemTickIndex = INDEX_NONE;
+}
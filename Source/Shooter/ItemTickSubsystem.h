@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemTickSubsystem.generated.h"
+
+class AItem;
+
+/**
+ * Ticks every item that currently needs per-frame work (falling, equip interping)
+ * from one contiguous array, so items don't own a tick function each.
+ */
+UCLASS()
+class SHOOTER_API UItemTickSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterItem(AItem* Item);
+	void UnregisterItem(AItem* Item);
+
+	FORCEINLINE int32 GetNumTickingItems() const { return TickingItems.Num(); }
+
+	/** Physics simulated weapon throws in progress in this world, see AWeapon::MaxSimulatedThrows */
+	FORCEINLINE int32 GetNumSimulatedThrows() const { return NumSimulatedThrows; }
+	FORCEINLINE void AddSimulatedThrow() { NumSimulatedThrows++; }
+	FORCEINLINE void RemoveSimulatedThrow() { NumSimulatedThrows = FMath::Max(NumSimulatedThrows - 1, 0); }
+
+private:
+	/** Each item stores its index in here, see AItem::ItemTickIndex */
+	UPROPERTY()
+	TArray<AItem*> TickingItems;
+
+	/** Set while Tick walks TickingItems, unregistering then nulls the slot instead of swapping */
+	bool bTickingItems = false;
+
+	int32 NumSimulatedThrows = 0;
+};
@@ -0,0 +1,209 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LagCompensationSubsystem.h"
+#include "Shooter.h"
+#include "ShooterCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "CollisionQueryParams.h"
+
+namespace
+{
+	/** Distance along Direction (unit) from Origin to the capsule A-B of Radius, negative if missed */
+	float IntersectRayCapsule(const FVector& Origin, const FVector& Direction, const FVector& A, const FVector& B, float Radius)
+	{
+		const FVector BA{ B - A };
+		const FVector OA{ Origin - A };
+		const double BABA{ BA | BA };
+		const double BARD{ BA | Direction };
+		const double BAOA{ BA | OA };
+		const double RDOA{ Direction | OA };
+		const double OAOA{ OA | OA };
+
+		// Cylinder
+		const double QA{ BABA - BARD * BARD };
+		double Y{ BARD > 0.0 ? 0.0 : BABA };
+		if (QA > SMALL_NUMBER)
+		{
+			const double QB{ BABA * RDOA - BAOA * BARD };
+			const double QC{ BABA * OAOA - BAOA * BAOA - Radius * Radius * BABA };
+			const double H{ QB * QB - QA * QC };
+			if (H < 0.0) return -1.f;
+
+			const double T{ (-QB - FMath::Sqrt(H)) / QA };
+			Y = BAOA + T * BARD;
+			if (Y > 0.0 && Y < BABA) return (float)T;
+		}
+
+		// Hemispheres
+		const FVector OC{ Y <= 0.0 ? OA : Origin - B };
+		const double SB{ Direction | OC };
+		const double SC{ (OC | OC) - Radius * Radius };
+		const double SH{ SB * SB - SC };
+		return SH > 0.0 ? (float)(-SB - FMath::Sqrt(SH)) : -1.f;
+	}
+}
+
+void FLagCompensationHistory::Record(const FLagCompensationFrame& Frame)
+{
+	Frames[Head] = Frame;
+	Head = (Head + 1) % MaxFrames;
+	NumFrames = FMath::Min(NumFrames + 1, MaxFrames);
+}
+
+bool FLagCompensationHistory::Rewind(float Time, FLagCompensationFrame& OutFrame) const
+{
+	if (NumFrames == 0) return false;
+
+	// Newest to oldest
+	const FLagCompensationFrame* Newer = nullptr;
+	for (int32 Age = 0; Age < NumFrames; ++Age)
+	{
+		const FLagCompensationFrame& Frame = Frames[(Head - 1 - Age + MaxFrames) % MaxFrames];
+		if (Frame.Time <= Time)
+		{
+			if (Newer == nullptr)
+			{
+				OutFrame = Frame;
+				return true;
+			}
+
+			const float Alpha{ (Time - Frame.Time) / FMath::Max(Newer->Time - Frame.Time, SMALL_NUMBER) };
+			OutFrame.Time = Time;
+			OutFrame.Location = FMath::Lerp(Frame.Location, Newer->Location, Alpha);
+			OutFrame.HalfHeight = FMath::Lerp(Frame.HalfHeight, Newer->HalfHeight, Alpha);
+			OutFrame.Radius = FMath::Lerp(Frame.Radius, Newer->Radius, Alpha);
+			return true;
+		}
+		Newer = &Frame;
+	}
+
+	// Older than the history
+	OutFrame = *Newer;
+	return true;
+}
+
+ULagCompensationSubsystem::ULagCompensationSubsystem() :
+	MaxRewindTime(0.25f)
+{
+}
+
+void ULagCompensationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	RecordCharacters(GetWorld()->GetTimeSeconds());
+}
+
+void ULagCompensationSubsystem::RecordCharacters(float Time)
+{
+	for (int32 Index = Histories.Num() - 1; Index >= 0; --Index)
+	{
+		FLagCompensationHistory& History = Histories[Index];
+		const AShooterCharacter* Character = History.Character.Get();
+		if (Character == nullptr)
+		{
+			Histories.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		FLagCompensationFrame Frame;
+		Frame.Time = Time;
+		Frame.Location = FVector3f(Capsule->GetComponentLocation());
+		Frame.HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+		Frame.Radius = Capsule->GetScaledCapsuleRadius();
+		History.Record(Frame);
+	}
+}
+
+TStatId ULagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+void ULagCompensationSubsystem::RegisterCharacter(AShooterCharacter* Character)
+{
+	if (Character == nullptr) return;
+
+	const bool bRegistered = Histories.ContainsByPredicate([Character](const FLagCompensationHistory& History)
+	{
+		return History.Character.Get() == Character;
+	});
+	if (bRegistered) return;
+
+	Histories.AddDefaulted_GetRef().Character = Character;
+}
+
+void ULagCompensationSubsystem::UnregisterCharacter(AShooterCharacter* Character)
+{
+	const int32 Index = Histories.IndexOfByPredicate([Character](const FLagCompensationHistory& History)
+	{
+		return History.Character.Get() == Character;
+	});
+	if (Index != INDEX_NONE)
+	{
+		Histories.RemoveAtSwap(Index, 1, false);
+	}
+}
+
+bool ULagCompensationSubsystem::TraceCharacters(
+	const FVector& Start,
+	const FVector& End,
+	float Time,
+	const AActor* IgnoredActor,
+	FLagCompensatedHit& OutHit) const
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterLagCompensation);
+
+	const FVector Delta{ End - Start };
+	const float Length{ (float)Delta.Size() };
+	if (Length <= SMALL_NUMBER) return false;
+	const FVector Direction{ Delta / Length };
+
+	const float RewindTime{ FMath::Max(Time, GetWorld()->GetTimeSeconds() - MaxRewindTime) };
+
+	bool bHit = false;
+	OutHit.Distance = Length;
+	for (const FLagCompensationHistory& History : Histories)
+	{
+		AShooterCharacter* Character = History.Character.Get();
+		if (Character == nullptr || Character == IgnoredActor) continue;
+
+		FLagCompensationFrame Frame;
+		if (!History.Rewind(RewindTime, Frame)) continue;
+		SHOOTER_INC_COUNTER(STAT_ShooterRewinds);
+
+		// Bounding sphere first
+		const FVector Center{ Frame.Location };
+		const FVector ToCenter{ Center - Start };
+		const double Along{ FMath::Clamp<double>(ToCenter | Direction, 0.0, Length) };
+		if ((ToCenter - Direction * Along).SizeSquared() > FMath::Square(Frame.HalfHeight)) continue;
+
+		// Character capsules stay upright
+		const FVector Axis{ 0.f, 0.f, FMath::Max(Frame.HalfHeight - Frame.Radius, 0.f) };
+		const float Distance{ IntersectRayCapsule(Start, Direction, Center - Axis, Center + Axis, Frame.Radius) };
+		if (Distance < 0.f || Distance >= OutHit.Distance) continue;
+
+		bHit = true;
+		OutHit.Character = Character;
+		OutHit.Distance = Distance;
+		OutHit.Location = Start + Direction * Distance;
+
+		// From the closest point of the axis
+		const FVector AxisPoint{ FMath::ClosestPointOnSegment(OutHit.Location, Center - Axis, Center + Axis) };
+		OutHit.Normal = (OutHit.Location - AxisPoint).GetSafeNormal();
+	}
+	return bHit;
+}
+
+void ULagCompensationSubsystem::AddIgnoredCharacters(FCollisionQueryParams& QueryParams) const
+{
+	for (const FLagCompensationHistory& History : Histories)
+	{
+		if (const AShooterCharacter* Character = History.Character.Get())
+		{
+			QueryParams.AddIgnoredActor(Character);
+		}
+	}
+}
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/StaticArray.h"
+#include "LagCompensationSubsystem.generated.h"
+
+class AShooterCharacter;
+struct FCollisionQueryParams;
+
+/** Capsule of one character at one server time */
+struct FLagCompensationFrame
+{
+	float Time = 0.f;
+	FVector3f Location = FVector3f::ZeroVector;
+	float HalfHeight = 0.f;
+	float Radius = 0.f;
+};
+
+/** Last frames of one character, the oldest is overwritten first */
+struct FLagCompensationHistory
+{
+	/** ~0.5 s at 60 Hz, 24 bytes each */
+	static constexpr int32 MaxFrames = 32;
+
+	TWeakObjectPtr<AShooterCharacter> Character;
+	TStaticArray<FLagCompensationFrame, MaxFrames> Frames;
+
+	/** Next frame to write */
+	int32 Head = 0;
+	int32 NumFrames = 0;
+
+	void Record(const FLagCompensationFrame& Frame);
+
+	/** Capsule interpolated at Time, clamped to the recorded range */
+	bool Rewind(float Time, FLagCompensationFrame& OutFrame) const;
+};
+
+/** Closest character a rewound ray hit */
+struct FLagCompensatedHit
+{
+	AShooterCharacter* Character = nullptr;
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::UpVector;
+	float Distance = 0.f;
+};
+
+/**
+ * Server side history of every character's capsule, so shots are resolved against
+ * where targets were when the client fired rather than where they are now.
+ */
+UCLASS()
+class SHOOTER_API ULagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	ULagCompensationSubsystem();
+
+	/** Records every character, after movement ran for the frame */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Adds a frame at Time to every history, Tick records at the world time */
+	void RecordCharacters(float Time);
+
+	void RegisterCharacter(AShooterCharacter* Character);
+	void UnregisterCharacter(AShooterCharacter* Character);
+
+	/**
+	 * Traces Start to End against the capsules of every character rewound to Time,
+	 * analytically, without touching the physics scene.
+	 */
+	bool TraceCharacters(const FVector& Start, const FVector& End, float Time, const AActor* IgnoredActor, FLagCompensatedHit& OutHit) const;
+
+	/** Characters are resolved by TraceCharacters, the world trace should skip their current capsule */
+	void AddIgnoredCharacters(FCollisionQueryParams& QueryParams) const;
+
+	FORCEINLINE int32 GetNumCharacters() const { return Histories.Num(); }
+	FORCEINLINE float GetMaxRewindTime() const { return MaxRewindTime; }
+
+private:
+	/** Shots older than this are resolved at this age */
+	float MaxRewindTime;
+
+	TArray<FLagCompensationHistory> Histories;
+};
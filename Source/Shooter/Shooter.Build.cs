@@ -9,9 +9,9 @@ public class Shooter : ModuleRules
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 	
 		PublicDependencyModuleNames.AddRange(new string[] { "Core",
-			"CoreUObject", "Engine", "InputCore", "UMG" });
+			"CoreUObject", "Engine", "InputCore", "UMG", "NetCore", "ReplicationGraph", "SignificanceManager" });
 
-		PrivateDependencyModuleNames.AddRange(new string[] {  });
+		PrivateDependencyModuleNames.AddRange(new string[] { "AIModule" });
 
 		// Uncomment if you are using Slate UI
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
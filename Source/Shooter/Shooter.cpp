@@ -3,4 +3,34 @@
 #include "Shooter.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogShooter);
+
+UE_TRACE_CHANNEL_DEFINE(ShooterChannel);
+
+CSV_DEFINE_CATEGORY_MODULE(SHOOTER_API, Shooter, true);
+
+DEFINE_STAT(STAT_ShooterCharacterTick);
+DEFINE_STAT(STAT_ShooterTraceFromCrosshair);
+DEFINE_STAT(STAT_ShooterTraceForItems);
+DEFINE_STAT(STAT_ShooterFireWeapon);
+DEFINE_STAT(STAT_ShooterSendBullet);
+DEFINE_STAT(STAT_ShooterCalculateCrosshairSpread);
+DEFINE_STAT(STAT_ShooterSetItemProperties);
+DEFINE_STAT(STAT_ShooterUpdateAnimationProperties);
+DEFINE_STAT(STAT_ShooterLagCompensation);
+
+DEFINE_STAT(STAT_ShooterTraces);
+DEFINE_STAT(STAT_ShooterFXSpawns);
+DEFINE_STAT(STAT_ShooterFXPoolHits);
+DEFINE_STAT(STAT_ShooterFXPoolMisses);
+DEFINE_STAT(STAT_ShooterFXPoolEvictions);
+DEFINE_STAT(STAT_ShooterItemStateChanges);
+DEFINE_STAT(STAT_ShooterRewinds);
+DEFINE_STAT(STAT_ShooterRejectedShots);
+DEFINE_STAT(STAT_ShooterPredictionCorrections);
+DEFINE_STAT(STAT_ShooterAnimUpdates);
+
+DEFINE_STAT(STAT_ShooterRootYawOffset);
+DEFINE_STAT(STAT_ShooterLeanYawDelta);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Shooter, "Shooter" );
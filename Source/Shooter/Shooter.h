@@ -3,4 +3,63 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 
+SHOOTER_API DECLARE_LOG_CATEGORY_EXTERN(LogShooter, Log, All);
+
+/** Insights channel for gameplay scopes, enable with -trace=cpu,Shooter */
+UE_TRACE_CHANNEL_EXTERN(ShooterChannel, SHOOTER_API);
+
+/** CSV category, captured per frame with -csvprofile (works with -nullrhi) */
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(SHOOTER_API, Shooter);
+
+/** "stat Shooter" */
+DECLARE_STATS_GROUP(TEXT("Shooter"), STATGROUP_Shooter, STATCAT_Advanced);
+
+// Hot paths
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character Tick"), STAT_ShooterCharacterTick, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TraceFromCrosshair"), STAT_ShooterTraceFromCrosshair, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TraceForItems"), STAT_ShooterTraceForItems, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FireWeapon"), STAT_ShooterFireWeapon, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SendBullet"), STAT_ShooterSendBullet, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CalculateCrosshairSpread"), STAT_ShooterCalculateCrosshairSpread, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SetItemProperties"), STAT_ShooterSetItemProperties, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("UpdateAnimationProperties"), STAT_ShooterUpdateAnimationProperties, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Lag Compensation"), STAT_ShooterLagCompensation, STATGROUP_Shooter, SHOOTER_API);
+
+// Per-frame counts
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces"), STAT_ShooterTraces, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("FX Spawns"), STAT_ShooterFXSpawns, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("FX Pool Hits"), STAT_ShooterFXPoolHits, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("FX Pool Misses"), STAT_ShooterFXPoolMisses, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("FX Pool Evictions"), STAT_ShooterFXPoolEvictions, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Item State Changes"), STAT_ShooterItemStateChanges, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rewinds"), STAT_ShooterRewinds, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rejected Shots"), STAT_ShooterRejectedShots, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Prediction Corrections"), STAT_ShooterPredictionCorrections, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Anim Updates"), STAT_ShooterAnimUpdates, STATGROUP_Shooter, SHOOTER_API);
+
+// Turn in place / lean, summed over every anim update of the frame (worker threads included), divide by Anim Updates for the mean
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Abs RootYawOffset Sum"), STAT_ShooterRootYawOffset, STATGROUP_Shooter, SHOOTER_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Abs LeanYawDelta Sum"), STAT_ShooterLeanYawDelta, STATGROUP_Shooter, SHOOTER_API);
+
+/** Cycle stat, Insights scope and CSV timing in one, all compile out when stats / trace / CSV are disabled */
+#define SHOOTER_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, ShooterChannel); \
+	CSV_SCOPED_TIMING_STAT(Shooter, Stat)
+
+/** Per-frame counter in both the stats system and the CSV profiler */
+#define SHOOTER_INC_COUNTER_BY(Stat, Amount) \
+	INC_DWORD_STAT_BY(Stat, Amount); \
+	CSV_CUSTOM_STAT(Shooter, Stat, (int32)(Amount), ECsvCustomStatOp::Accumulate)
+
+#define SHOOTER_INC_COUNTER(Stat) SHOOTER_INC_COUNTER_BY(Stat, 1)
+
+/** Float version, safe from any thread like the one above */
+#define SHOOTER_INC_FLOAT_COUNTER_BY(Stat, Amount) \
+	INC_FLOAT_STAT_BY(Stat, Amount); \
+	CSV_CUSTOM_STAT(Shooter, Stat, (float)(Amount), ECsvCustomStatOp::Accumulate)
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterAmmoCounts.h"
+
+FShooterAmmoCounts::FShooterAmmoCounts()
+{
+	for (int32& Count : Counts)
+	{
+		Count = 0;
+	}
+}
+
+int32 FShooterAmmoCounts::Get(EMyAmmoType AmmoType) const
+{
+	const int32 Index{ (int32)AmmoType };
+	return Index < Counts.Num() ? Counts[Index] : 0;
+}
+
+void FShooterAmmoCounts::Set(EMyAmmoType AmmoType, int32 Count)
+{
+	const int32 Index{ (int32)AmmoType };
+	if (Index < Counts.Num())
+	{
+		Counts[Index] = FMath::Max(Count, 0);
+	}
+}
+
+bool FShooterAmmoCounts::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	// Counts are small and never negative, a byte each in most cases
+	for (int32& Count : Counts)
+	{
+		uint32 PackedCount{ (uint32)Count };
+		Ar.SerializeIntPacked(PackedCount);
+		if (Ar.IsLoading())
+		{
+			Count = (int32)FMath::Min<uint32>(PackedCount, MAX_int32);
+		}
+	}
+
+	bOutSuccess = true;
+	return true;
+}
+
+bool FShooterAmmoCounts::operator==(const FShooterAmmoCounts& Other) const
+{
+	for (int32 Index = 0; Index < Counts.Num(); ++Index)
+	{
+		if (Counts[Index] != Other.Counts[Index]) return false;
+	}
+	return true;
+}
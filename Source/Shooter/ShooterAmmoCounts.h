@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "MyAmmoType.h"
+#include "ShooterAmmoCounts.generated.h"
+
+/** Carried ammo per EMyAmmoType, replicated as one packed int per type */
+USTRUCT()
+struct SHOOTER_API FShooterAmmoCounts
+{
+	GENERATED_BODY()
+
+	FShooterAmmoCounts();
+
+	int32 Get(EMyAmmoType AmmoType) const;
+	void Set(EMyAmmoType AmmoType, int32 Count);
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FShooterAmmoCounts& Other) const;
+
+private:
+	TStaticArray<int32, (int32)EMyAmmoType::EAT_NAX> Counts;
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterAmmoCounts> : public TStructOpsTypeTraitsBase2<FShooterAmmoCounts>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		// Counts is not a UPROPERTY, compare it with operator==
+		WithIdenticalViaEquality = true,
+	};
+};
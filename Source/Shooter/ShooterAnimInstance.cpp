@@ -1,4 +1,5 @@
 #include "ShooterAnimInstance.h"
+#include "Shooter.h"
 #include "ShooterCharacter.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/KismetMathLibrary.h"
@@ -11,6 +12,7 @@ UShooterAnimInstance::UShooterAnimInstance():
 	MovementOffsetYaw(0.f),
 	LastMovementOffsetYaw(0.f),
 	bAiming(false),
+	bHasCharacterSnapshot(false),
 	// turn
 	TIPCharacterYaw(0.f),
 	TIPCharacterYawLastFrame(0.f),
@@ -28,88 +30,121 @@ UShooterAnimInstance::UShooterAnimInstance():
 
 }
 
+namespace ShooterAnimCurves
+{
+	static const FName Turning(TEXT("Turning"));
+	static const FName Rotation(TEXT("Rotation"));
+}
+
 void UShooterAnimInstance::NativeInitializeAnimation()
 {
+	Super::NativeInitializeAnimation();
+
 	ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
 }
 
-// Tick
-void UShooterAnimInstance::UpdateAnimationProperties(float deltaTime)
+void UShooterAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeUpdateAnimation(DeltaSeconds);
+
+	TakeCharacterSnapshot();
+}
+
+void UShooterAnimInstance::TakeCharacterSnapshot()
 {
 	if (ShooterCharacter == nullptr)
 	{
 		ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
 	}
 
-	if (ShooterCharacter)
-	{
-		// reloading
-		bReloading = ShooterCharacter->GetCombatState() == ECombatState::ECS_Reloading;
-		bCrouching = ShooterCharacter->GetCrouching();
+	bHasCharacterSnapshot = ShooterCharacter != nullptr;
+	if (!bHasCharacterSnapshot) return;
 
-		// speed
-		FVector velocity = ShooterCharacter->GetVelocity();
-		velocity.Z = 0;
-		Speed = velocity.Size();
+	const UCharacterMovementComponent* CharacterMovement = ShooterCharacter->GetCharacterMovement();
 
-		// in air
-		bIsInAir = ShooterCharacter->GetCharacterMovement()->IsFalling();
+	CharacterSnapshot.Velocity = ShooterCharacter->GetVelocity();
+	CharacterSnapshot.AimRotation = ShooterCharacter->GetBaseAimRotation();
+	CharacterSnapshot.ActorRotation = ShooterCharacter->GetActorRotation();
+	CharacterSnapshot.bIsFalling = CharacterMovement->IsFalling();
+	CharacterSnapshot.bIsAccelerating = CharacterMovement->GetCurrentAcceleration().Size() > 0.f;
+	CharacterSnapshot.bReloading = ShooterCharacter->GetCombatState() == ECombatState::ECS_Reloading;
+	CharacterSnapshot.bCrouching = ShooterCharacter->GetCrouching();
+	CharacterSnapshot.bAiming = ShooterCharacter->GetAiming();
+}
 
-		// acce
-		if (ShooterCharacter->GetCharacterMovement()->GetCurrentAcceleration().Size() > 0.f)
-		{
-			bIsAccelerating = true;
-		}
-		else
-		{
-			bIsAccelerating = false;
-		}
+void UShooterAnimInstance::UpdateAnimationProperties(float deltaTime)
+{
+}
 
-		// rotation
-		FRotator AimRotation = ShooterCharacter->GetBaseAimRotation();
-		FRotator MovementRotation =
-			UKismetMathLibrary::MakeRotFromX(
-				ShooterCharacter->GetVelocity());
+// Tick
+void UShooterAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
 
-		MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(
-			MovementRotation,
-			AimRotation).Yaw;
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterUpdateAnimationProperties);
 
-		if (ShooterCharacter->GetVelocity().Size() > 0.f)
-		{
-			LastMovementOffsetYaw = MovementOffsetYaw;
-		}
-		
-		bAiming = ShooterCharacter->GetAiming();
+	if (!bHasCharacterSnapshot) return;
+	SHOOTER_INC_COUNTER(STAT_ShooterAnimUpdates);
 
-		if (bReloading)
-		{
-			OffsetState = EOffsetState::EOS_Reloading;
-		}
-		else if (bIsInAir)
-		{
-			OffsetState = EOffsetState::EOS_InAir;
-		}
-		else if (ShooterCharacter->GetAiming())
-		{
-			OffsetState = EOffsetState::EOS_Aiming;
-		}
-		else
-		{
-			OffsetState = EOffsetState::EOS_Hip;
-		}
+	// reloading
+	bReloading = CharacterSnapshot.bReloading;
+	bCrouching = CharacterSnapshot.bCrouching;
+
+	// speed
+	FVector velocity = CharacterSnapshot.Velocity;
+	velocity.Z = 0;
+	Speed = velocity.Size();
+
+	// in air
+	bIsInAir = CharacterSnapshot.bIsFalling;
+
+	// acce
+	bIsAccelerating = CharacterSnapshot.bIsAccelerating;
+
+	// rotation
+	FRotator AimRotation = CharacterSnapshot.AimRotation;
+	FRotator MovementRotation =
+		UKismetMathLibrary::MakeRotFromX(
+			CharacterSnapshot.Velocity);
+
+	MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(
+		MovementRotation,
+		AimRotation).Yaw;
+
+	if (CharacterSnapshot.Velocity.Size() > 0.f)
+	{
+		LastMovementOffsetYaw = MovementOffsetYaw;
+	}
+	
+	bAiming = CharacterSnapshot.bAiming;
+
+	if (bReloading)
+	{
+		OffsetState = EOffsetState::EOS_Reloading;
+	}
+	else if (bIsInAir)
+	{
+		OffsetState = EOffsetState::EOS_InAir;
+	}
+	else if (bAiming)
+	{
+		OffsetState = EOffsetState::EOS_Aiming;
+	}
+	else
+	{
+		OffsetState = EOffsetState::EOS_Hip;
 	}
 
 	TurnInPlace();
-	Lean(deltaTime);
+	Lean(DeltaSeconds);
 }
 
 
 void UShooterAnimInstance::TurnInPlace()
 {
-	if (ShooterCharacter == nullptr) return;
+	if (!bHasCharacterSnapshot) return;
 
-	Pitch = ShooterCharacter->GetBaseAimRotation().Pitch;
+	Pitch = CharacterSnapshot.AimRotation.Pitch;
 
 	// move or jump, reset
 	if (Speed > 0 || bIsInAir)
@@ -117,7 +152,7 @@ void UShooterAnimInstance::TurnInPlace()
 		// Don't want to turn in place; Character is moving
 		RootYawOffset = 0.f;
 		
-		TIPCharacterYaw = ShooterCharacter->GetActorRotation().Yaw;
+		TIPCharacterYaw = CharacterSnapshot.ActorRotation.Yaw;
 		TIPCharacterYawLastFrame = TIPCharacterYaw;
 		
 		RotationCurve = 0.f;
@@ -126,17 +161,17 @@ void UShooterAnimInstance::TurnInPlace()
 	else
 	{
 		TIPCharacterYawLastFrame = TIPCharacterYaw;
-		TIPCharacterYaw = ShooterCharacter->GetActorRotation().Yaw;
+		TIPCharacterYaw = CharacterSnapshot.ActorRotation.Yaw;
 		const float TIPYawDelta{ TIPCharacterYaw - TIPCharacterYawLastFrame };
 
 		// Root Yaw Offset, updated and clamped to [-180, 180]
 		RootYawOffset = UKismetMathLibrary::NormalizeAxis(RootYawOffset - TIPYawDelta);
 
 		// 1.0 if turning, 0.0 if not
-		const float Turning{ GetCurveValue(TEXT("Turning")) };
+		const float Turning{ GetCurveValue(ShooterAnimCurves::Turning) };
 		if (Turning > 0)
 		{
-			RotationCurve = GetCurveValue(TEXT("Rotation"));
+			RotationCurve = GetCurveValue(ShooterAnimCurves::Rotation);
 			const float DeltaRotation{ RotationCurve - RotationCurveLastFrame };
 
 			// RootYawOffset > 0, -> Turning Left. RootYawOffset < 0, -> Turning Right.
@@ -152,26 +187,17 @@ void UShooterAnimInstance::TurnInPlace()
 			RotationCurveLastFrame = RotationCurve;
 		}
 
-		if (GEngine) GEngine->AddOnScreenDebugMessage(
-			1, 
-			-1, 
-			FColor::Blue, 
-			FString::Printf(TEXT("TIPCharacterYaw: %f"), TIPCharacterYaw));
-		if (GEngine) GEngine->AddOnScreenDebugMessage(
-			2,
-			-1,
-			FColor::Red,
-			FString::Printf(TEXT("RootYawOffset: %f"), RootYawOffset));
+		SHOOTER_INC_FLOAT_COUNTER_BY(STAT_ShooterRootYawOffset, FMath::Abs(RootYawOffset));
 	}
 }
 
 #pragma region Lean
 void UShooterAnimInstance::Lean(float DeltaTime)
 {
-	if (ShooterCharacter == nullptr) return;
+	if (!bHasCharacterSnapshot) return;
 
 	CharacterRotationLastFrame = CharacterRotation;
-	CharacterRotation = ShooterCharacter->GetActorRotation();
+	CharacterRotation = CharacterSnapshot.ActorRotation;
 
 	const FRotator DeltaRot{ UKismetMathLibrary::NormalizedDeltaRotator(CharacterRotation, CharacterRotationLastFrame) };
 
@@ -180,10 +206,6 @@ void UShooterAnimInstance::Lean(float DeltaTime)
 		FMath::FInterpTo(LeanYawDelta, Target, DeltaTime, LeanInterpSpeed) };
 	LeanYawDelta = FMath::Clamp(Interp, -90.f, 90.f);
 
-	if (GEngine) GEngine->AddOnScreenDebugMessage(
-			1, 
-			-1, 
-			FColor::Blue, 
-			FString::Printf(TEXT("LeanYawDelta.Yaw: %f"), DeltaRot.Yaw));
+	SHOOTER_INC_FLOAT_COUNTER_BY(STAT_ShooterLeanYawDelta, FMath::Abs(DeltaRot.Yaw));
 }
 #pragma endregion
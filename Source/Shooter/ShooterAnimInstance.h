@@ -18,6 +18,19 @@ enum class EOffsetState : uint8
 	EOS_MAX UMETA(DisplayName = "DefaultMAX")
 };
 
+/** Character state copied on the game thread, read by the worker thread animation update */
+struct FShooterAnimCharacterSnapshot
+{
+	FVector Velocity = FVector::ZeroVector;
+	FRotator AimRotation = FRotator::ZeroRotator;
+	FRotator ActorRotation = FRotator::ZeroRotator;
+	bool bIsFalling = false;
+	bool bIsAccelerating = false;
+	bool bReloading = false;
+	bool bCrouching = false;
+	bool bAiming = false;
+};
+
 
 UCLASS()
 class SHOOTER_API UShooterAnimInstance : public UAnimInstance
@@ -52,12 +65,26 @@ private:
 #pragma region Public
 public:
 
-	UFUNCTION(BlueprintCallable)
+	/** Properties are now updated natively in NativeThreadSafeUpdateAnimation, remove the call from the event graph */
+	UFUNCTION(BlueprintCallable, meta = (DeprecatedFunction, DeprecationMessage = "Updated natively, remove this call from the AnimBP event graph"))
 		void UpdateAnimationProperties(float deltaTime);
 
 	virtual void NativeInitializeAnimation() override;
+
+	/** Game thread: copies the character state the update needs */
+	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+
+	/** Worker thread: updates the animation properties from the snapshot */
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override;
 #pragma endregion
 
+private:
+	/** Reads the owning character, game thread only */
+	void TakeCharacterSnapshot();
+
+	bool bHasCharacterSnapshot;
+	FShooterAnimCharacterSnapshot CharacterSnapshot;
+
 
 #pragma region Turn
 
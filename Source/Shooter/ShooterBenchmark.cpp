@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterBenchmark.h"
+#include "Shooter.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+FShooterBenchmarkSamples::FShooterBenchmarkSamples(const FString& InName, int32 ExpectedSamples) :
+	Name(InName)
+{
+	Microseconds.Reserve(ExpectedSamples);
+}
+
+void FShooterBenchmarkSamples::Add(double Seconds)
+{
+	Microseconds.Add(Seconds * 1e6);
+}
+
+double FShooterBenchmarkSamples::GetMean() const
+{
+	if (Microseconds.Num() == 0) return 0.0;
+
+	double Sum = 0.0;
+	for (const double Sample : Microseconds)
+	{
+		Sum += Sample;
+	}
+	return Sum / Microseconds.Num();
+}
+
+double FShooterBenchmarkSamples::GetPercentile(double Percentile) const
+{
+	if (Microseconds.Num() == 0) return 0.0;
+
+	TArray<double> Sorted = Microseconds;
+	Sorted.Sort();
+	const int32 Rank{ FMath::CeilToInt(FMath::Clamp(Percentile, 0.0, 1.0) * Sorted.Num()) };
+	return Sorted[FMath::Clamp(Rank - 1, 0, Sorted.Num() - 1)];
+}
+
+void FShooterBenchmarkSamples::Log() const
+{
+	const double Mean{ GetMean() };
+	const double P99{ GetPercentile(0.99) };
+
+	UE_LOG(LogShooter, Log, TEXT("  %-32s mean %10.3f us  p99 %10.3f us  (%d samples)"), *Name, Mean, P99, Microseconds.Num());
+	CSV_EVENT(Shooter, TEXT("Benchmark %s mean %.3f p99 %.3f"), *Name, Mean, P99);
+}
+
+FShooterBenchmarkReport::FShooterBenchmarkReport(const FString& InName) :
+	Name(InName)
+{
+}
+
+FShooterBenchmarkSamples& FShooterBenchmarkReport::AddCase(const FString& CaseName, int32 ExpectedSamples)
+{
+	const int32 Index{ Cases.Add(new FShooterBenchmarkSamples(CaseName, ExpectedSamples)) };
+	return Cases[Index];
+}
+
+void FShooterBenchmarkReport::AddNote(const FString& Note)
+{
+	Notes.Add(Note);
+}
+
+void FShooterBenchmarkReport::AddError(const FString& Error)
+{
+	UE_LOG(LogShooter, Warning, TEXT("%s benchmark: %s"), *Name, *Error);
+	Errors.Add(Error);
+}
+
+void FShooterBenchmarkReport::Finish(const FString& Heading)
+{
+	UE_LOG(LogShooter, Log, TEXT("%s:"), *Heading);
+
+	FString Csv = FString::Printf(TEXT("# %s\nCase,MeanUs,P99Us,Samples\n"), *Heading);
+	for (const FShooterBenchmarkSamples& Samples : Cases)
+	{
+		Samples.Log();
+		Csv += FString::Printf(TEXT("\"%s\",%.3f,%.3f,%d\n"), *Samples.Name, Samples.GetMean(), Samples.GetPercentile(0.99), Samples.Num());
+	}
+	for (const FString& Note : Notes)
+	{
+		UE_LOG(LogShooter, Log, TEXT("  %s"), *Note);
+		Csv += FString::Printf(TEXT("# %s\n"), *Note);
+	}
+	for (const FString& Error : Errors)
+	{
+		Csv += FString::Printf(TEXT("# Error: %s\n"), *Error);
+	}
+
+	const FString FileName{ FPaths::ProjectSavedDir() / TEXT("Benchmarks") /
+		FString::Printf(TEXT("%s-%s.csv"), *Name, *FDateTime::Now().ToString()) };
+	if (FFileHelper::SaveStringToFile(Csv, *FileName))
+	{
+		UE_LOG(LogShooter, Log, TEXT("  Written to %s"), *FileName);
+	}
+}
+
+FVector ShooterBenchmark::GetSpawnOrigin(const UWorld* World)
+{
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	{
+		return It->GetActorLocation();
+	}
+	return FVector::ZeroVector;
+}
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/** Timings of one benchmark case, one sample per iteration, logged as mean and p99 */
+struct SHOOTER_API FShooterBenchmarkSamples
+{
+	explicit FShooterBenchmarkSamples(const FString& InName, int32 ExpectedSamples = 0);
+
+	void Add(double Seconds);
+
+	FORCEINLINE int32 Num() const { return Microseconds.Num(); }
+
+	double GetMean() const;
+
+	/** Percentile in [0, 1] of the samples, nearest rank */
+	double GetPercentile(double Percentile) const;
+
+	/** One line to LogShooter and a CSV event, "name  mean  p99  samples" in microseconds */
+	void Log() const;
+
+	FString Name;
+	TArray<double> Microseconds;
+};
+
+/**
+ * Cases of one benchmark run. Logged together and written to Saved/Benchmarks/<Name>-<date>.csv,
+ * one row per case, so runs can be diffed between builds. Failed expectations are kept for the
+ * Shooter.Benchmarks automation tests.
+ */
+struct SHOOTER_API FShooterBenchmarkReport
+{
+	explicit FShooterBenchmarkReport(const FString& InName);
+
+	/** The reference stays valid as long as the report */
+	FShooterBenchmarkSamples& AddCase(const FString& CaseName, int32 ExpectedSamples = 0);
+
+	/** A line logged and written under the cases, e.g. hit counts */
+	void AddNote(const FString& Note);
+
+	/** A failed expectation, logged as a warning right away */
+	void AddError(const FString& Error);
+
+	/** Logs Heading, the cases and the notes, then writes the results file */
+	void Finish(const FString& Heading);
+
+	FORCEINLINE const TArray<FString>& GetErrors() const { return Errors; }
+
+	FString Name;
+	TIndirectArray<FShooterBenchmarkSamples> Cases;
+	TArray<FString> Notes;
+	TArray<FString> Errors;
+};
+
+namespace ShooterBenchmark
+{
+	/** Where stress actors are spawned, the first player start or the world origin */
+	SHOOTER_API FVector GetSpawnOrigin(const UWorld* World);
+}
+
+/** Adds the time spent in its scope to Samples */
+struct FShooterBenchmarkScope
+{
+	explicit FShooterBenchmarkScope(FShooterBenchmarkSamples& InSamples) :
+		Samples(InSamples),
+		StartTime(FPlatformTime::Seconds())
+	{
+	}
+
+	~FShooterBenchmarkScope()
+	{
+		Samples.Add(FPlatformTime::Seconds() - StartTime);
+	}
+
+private:
+	FShooterBenchmarkSamples& Samples;
+	double StartTime;
+};
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterBenchmarkSubsystem.h"
+#include "Shooter.h"
+#include "ShooterBenchmark.h"
+#include "Engine/World.h"
+
+void UShooterBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!Report.IsValid()) return;
+
+	// The scripted actions count towards this frame
+	if (OnFrame)
+	{
+		OnFrame(Frame);
+	}
+
+	for (int32 Index = 0; Index < (int32)EShooterFrameTiming::Num; ++Index)
+	{
+		Samples[Index]->Add(FrameSeconds[Index]);
+		FrameSeconds[Index] = 0.0;
+	}
+
+	const double Now{ FPlatformTime::Seconds() };
+	Samples.Last()->Add(Now - FrameStartTime);
+	FrameStartTime = Now;
+
+	if (++Frame < NumFrames) return;
+
+	// OnFinished may start the next recording
+	TFunction<void()> Finished = MoveTemp(OnFinished);
+	Report.Reset();
+	Samples.Reset();
+	OnFrame.Reset();
+	if (Finished)
+	{
+		Finished();
+	}
+}
+
+TStatId UShooterBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterBenchmarkSubsystem::StartRecording(const TSharedRef<FShooterBenchmarkReport>& InReport, int32 Frames,
+	TFunction<void(int32 Frame)> InOnFrame, TFunction<void()> InOnFinished)
+{
+	Report = InReport;
+	Samples.Reset();
+	Samples.Add(&InReport->AddCase(TEXT("AShooterCharacter::Tick, all characters"), Frames));
+	Samples.Add(&InReport->AddCase(TEXT("FireWeapon, all characters"), Frames));
+	Samples.Add(&InReport->AddCase(TEXT("TraceForItems, all characters"), Frames));
+	Samples.Add(&InReport->AddCase(TEXT("Item state transitions"), Frames));
+	Samples.Add(&InReport->AddCase(TEXT("Whole frame"), Frames));
+
+	FMemory::Memzero(FrameSeconds);
+	FrameStartTime = FPlatformTime::Seconds();
+	Frame = 0;
+	NumFrames = FMath::Max(Frames, 1);
+	OnFrame = MoveTemp(InOnFrame);
+	OnFinished = MoveTemp(InOnFinished);
+}
+
+FShooterFrameTimingScope::FShooterFrameTimingScope(const UWorld* World, EShooterFrameTiming InTiming) :
+	Subsystem(nullptr),
+	Timing(InTiming),
+	StartTime(0.0)
+{
+	UShooterBenchmarkSubsystem* BenchmarkSubsystem = World ? World->GetSubsystem<UShooterBenchmarkSubsystem>() : nullptr;
+	if (BenchmarkSubsystem && BenchmarkSubsystem->IsRecording())
+	{
+		Subsystem = BenchmarkSubsystem;
+		StartTime = FPlatformTime::Seconds();
+	}
+}
+
+FShooterFrameTimingScope::~FShooterFrameTimingScope()
+{
+	if (Subsystem)
+	{
+		Subsystem->AddTime(Timing, FPlatformTime::Seconds() - StartTime);
+	}
+}
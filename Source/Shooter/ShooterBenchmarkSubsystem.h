@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterBenchmarkSubsystem.generated.h"
+
+struct FShooterBenchmarkReport;
+struct FShooterBenchmarkSamples;
+
+/** Gameplay scopes a frame benchmark times, inclusive, summed over the frame */
+enum class EShooterFrameTiming : uint8
+{
+	CharacterTick,
+	FireWeapon,
+	TraceForItems,
+	ItemStateChange,
+	Num
+};
+
+/**
+ * Records the game thread time of the EShooterFrameTiming scopes per frame while a frame benchmark
+ * (ShooterBenchmarkCombatSequences) runs over real frames. Outside of one the scopes only look it up.
+ */
+UCLASS()
+class SHOOTER_API UShooterBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Records the next Frames frames into Report, one case per timing plus the whole frame. OnFrame runs at
+	 * the end of each recorded frame and counts towards it, OnFinished after the last one.
+	 */
+	void StartRecording(const TSharedRef<FShooterBenchmarkReport>& InReport, int32 Frames,
+		TFunction<void(int32 Frame)> InOnFrame, TFunction<void()> InOnFinished);
+
+	FORCEINLINE bool IsRecording() const { return Report.IsValid(); }
+
+	FORCEINLINE void AddTime(EShooterFrameTiming Timing, double Seconds) { FrameSeconds[(int32)Timing] += Seconds; }
+
+private:
+	TSharedPtr<FShooterBenchmarkReport> Report;
+
+	/** Cases of Report, by EShooterFrameTiming, then the whole frame */
+	TArray<FShooterBenchmarkSamples*, TInlineAllocator<(int32)EShooterFrameTiming::Num + 1>> Samples;
+
+	double FrameSeconds[(int32)EShooterFrameTiming::Num] = {};
+	double FrameStartTime = 0.0;
+
+	int32 Frame = 0;
+	int32 NumFrames = 0;
+
+	TFunction<void(int32)> OnFrame;
+	TFunction<void()> OnFinished;
+};
+
+/** Adds the time spent in its scope to the world's recorded frame, while a frame benchmark runs */
+struct SHOOTER_API FShooterFrameTimingScope
+{
+	FShooterFrameTimingScope(const UWorld* World, EShooterFrameTiming InTiming);
+	~FShooterFrameTimingScope();
+
+private:
+	UShooterBenchmarkSubsystem* Subsystem;
+	EShooterFrameTiming Timing;
+	double StartTime;
+};
@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterGameModeBase.h"
+#include "Shooter.h"
+#include "ShooterBenchmark.h"
+#include "ShooterBenchmarkSubsystem.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * The Shooter.Benchmarks tests run the game mode's benchmark execs in a game world of their own, so
+ * they need neither PIE nor a map and run headless (-nullrhi) on the build machines. They measure
+ * the project's own classes and assets; results go to LogShooter, the CSV profile and Saved/Benchmarks,
+ * and a failed expectation in the benchmark's report fails its test.
+ */
+namespace ShooterBenchmarkTests
+{
+	/** An empty game world with the project's default game mode as its authority, destroyed with the scope */
+	class FBenchmarkWorld
+	{
+	public:
+		FBenchmarkWorld()
+		{
+			GameInstance = NewObject<UGameInstance>(GEngine);
+			GameInstance->AddToRoot();
+
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("ShooterBenchmarkWorld"));
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+			World->SetGameInstance(GameInstance);
+
+			// GlobalDefaultGameMode, the blueprint with the stress classes set
+			const FURL URL;
+			World->SetGameMode(URL);
+			World->InitializeActorsForPlay(URL);
+			World->BeginPlay();
+		}
+
+		~FBenchmarkWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+			GameInstance->RemoveFromRoot();
+		}
+
+		AShooterGameModeBase* GetGameMode() const
+		{
+			return World->GetAuthGameMode<AShooterGameModeBase>();
+		}
+
+		/** Ticks frames of FrameTime seconds while ShouldContinue holds, at most MaxFrames; false if it still held */
+		bool TickWhile(TFunctionRef<bool()> ShouldContinue, int32 MaxFrames, float FrameTime = 1.f / 60.f)
+		{
+			for (int32 Frame = 0; Frame < MaxFrames; ++Frame)
+			{
+				if (!ShouldContinue()) return true;
+
+				World->Tick(LEVELTICK_All, FrameTime);
+			}
+			return !ShouldContinue();
+		}
+
+		UWorld* World;
+
+	private:
+		UGameInstance* GameInstance;
+	};
+
+	/** Runs Benchmark in a fresh world and turns its report's errors into test errors */
+	bool RunBenchmark(FAutomationTestBase& Test, TFunctionRef<void(FBenchmarkWorld&, AShooterGameModeBase&)> Benchmark)
+	{
+		FBenchmarkWorld BenchmarkWorld;
+		AShooterGameModeBase* GameMode = BenchmarkWorld.GetGameMode();
+		if (GameMode == nullptr)
+		{
+			Test.AddError(TEXT("GlobalDefaultGameMode is not a shooter game mode"));
+			return false;
+		}
+
+		Benchmark(BenchmarkWorld, *GameMode);
+
+		TSharedPtr<const FShooterBenchmarkReport> Report = GameMode->GetLastBenchmarkReport();
+		if (!Report.IsValid())
+		{
+			Test.AddError(TEXT("The benchmark made no report"));
+			return false;
+		}
+		for (const FString& Error : Report->GetErrors())
+		{
+			Test.AddError(FString::Printf(TEXT("%s: %s"), *Report->Name, *Error));
+		}
+		return Report->GetErrors().Num() == 0;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterCombatSequencesBenchmark, "Shooter.Benchmarks.CombatSequences",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterCombatSequencesBenchmark::RunTest(const FString& Parameters)
+{
+	return ShooterBenchmarkTests::RunBenchmark(*this, [this](ShooterBenchmarkTests::FBenchmarkWorld& BenchmarkWorld, AShooterGameModeBase& GameMode)
+	{
+		constexpr int32 Frames{ 600 };
+		GameMode.ShooterBenchmarkCombatSequences(16, 1000, Frames);
+
+		// Recorded over real frames of the benchmark world
+		UShooterBenchmarkSubsystem* BenchmarkSubsystem = BenchmarkWorld.World->GetSubsystem<UShooterBenchmarkSubsystem>();
+		const bool bFinished{ BenchmarkWorld.TickWhile([BenchmarkSubsystem]()
+		{
+			return BenchmarkSubsystem && BenchmarkSubsystem->IsRecording();
+		}, Frames + 60) };
+		if (!bFinished)
+		{
+			AddError(TEXT("The combat sequence benchmark did not finish recording"));
+		}
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterItemStatesBenchmark, "Shooter.Benchmarks.ItemStates",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterItemStatesBenchmark::RunTest(const FString& Parameters)
+{
+	return ShooterBenchmarkTests::RunBenchmark(*this, [](ShooterBenchmarkTests::FBenchmarkWorld&, AShooterGameModeBase& GameMode)
+	{
+		GameMode.ShooterBenchmarkItemStates();
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterShotBandwidthBenchmark, "Shooter.Benchmarks.ShotBandwidth",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterShotBandwidthBenchmark::RunTest(const FString& Parameters)
+{
+	return ShooterBenchmarkTests::RunBenchmark(*this, [](ShooterBenchmarkTests::FBenchmarkWorld&, AShooterGameModeBase& GameMode)
+	{
+		GameMode.ShooterBenchmarkShotBandwidth();
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterHitscanBenchmark, "Shooter.Benchmarks.Hitscan",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterHitscanBenchmark::RunTest(const FString& Parameters)
+{
+	return ShooterBenchmarkTests::RunBenchmark(*this, [](ShooterBenchmarkTests::FBenchmarkWorld&, AShooterGameModeBase& GameMode)
+	{
+		// Something for the pellets to hit
+		GameMode.ShooterSpawnStressActors(64, 1000);
+		GameMode.ShooterBenchmarkHitscan();
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterItemProximityBenchmark, "Shooter.Benchmarks.ItemProximity",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterItemProximityBenchmark::RunTest(const FString& Parameters)
+{
+	return ShooterBenchmarkTests::RunBenchmark(*this, [](ShooterBenchmarkTests::FBenchmarkWorld&, AShooterGameModeBase& GameMode)
+	{
+		GameMode.ShooterBenchmarkItemProximity();
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterFirstShotBenchmark, "Shooter.Benchmarks.FirstShot",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterFirstShotBenchmark::RunTest(const FString& Parameters)
+{
+	return ShooterBenchmarkTests::RunBenchmark(*this, [](ShooterBenchmarkTests::FBenchmarkWorld&, AShooterGameModeBase& GameMode)
+	{
+		// Nothing in the fresh world has fired or warmed combat assets yet, the first character's shot is
+		// cold. A first shot over twice the tenth fails the test through the report
+		GameMode.ShooterBenchmarkFirstShot(20, 2.f);
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterWeaponRigBenchmark, "Shooter.Benchmarks.WeaponRig",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterWeaponRigBenchmark::RunTest(const FString& Parameters)
+{
+	return ShooterBenchmarkTests::RunBenchmark(*this, [](ShooterBenchmarkTests::FBenchmarkWorld&, AShooterGameModeBase& GameMode)
+	{
+		GameMode.ShooterBenchmarkWeaponRig();
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterLagCompensationBenchmark, "Shooter.Benchmarks.LagCompensation",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterLagCompensationBenchmark::RunTest(const FString& Parameters)
+{
+	return ShooterBenchmarkTests::RunBenchmark(*this, [](ShooterBenchmarkTests::FBenchmarkWorld&, AShooterGameModeBase& GameMode)
+	{
+		GameMode.ShooterBenchmarkLagCompensation();
+	});
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -1,4 +1,5 @@
 #include "ShooterCharacter.h"
+#include "Shooter.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Camera/CameraComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
@@ -8,10 +9,32 @@
 #include "DrawDebugHelpers.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Item.h"
-#include "Components/WidgetComponent.h"
 #include "Weapon.h"
 #include "Components/SphereComponent.h"
 #include "Components/BoxComponent.h"
+#include "CombatFXSubsystem.h"
+#include "HitscanBatch.h"
+#include "ItemProximitySubsystem.h"
+#include "Components/CapsuleComponent.h"
+#include "WeaponDataAsset.h"
+#include "Engine/AssetManager.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "LagCompensationSubsystem.h"
+#include "ShooterSignificanceManager.h"
+#include "ShooterPlayerController.h"
+#include "ShooterBenchmarkSubsystem.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarShooterAsyncTraces(
+	TEXT("Shooter.AsyncTraces"),
+	false,
+	TEXT("Run crosshair and barrel traces through the async trace queue instead of on the game thread.\n")
+	TEXT("Item highlighting then uses the previous frame's result and shot FX resolve in a completion callback."));
+
+FOnShooterCharacterWeapon AShooterCharacter::NotifyEquipWeapon;
+FOnShooterCharacterWeapon AShooterCharacter::NotifyUnEquipWeapon;
 
 // Sets default values
 AShooterCharacter::AShooterCharacter() :
@@ -27,6 +50,8 @@ AShooterCharacter::AShooterCharacter() :
 	MouseHipLookUpRate(1.0f),
 	MouseAimingTurnRate(0.2f),
 	MouseAimingLookUpRate(0.2f),
+	// FX
+	FXPrewarmCount(4),
 	// aim
 	bAiming(false),
 	// FOV
@@ -53,6 +78,20 @@ AShooterCharacter::AShooterCharacter() :
 	// ammo
 	Starting9mmAmmo(85),
 	StartingARAmmo(120),
+	ShotSeed(0),
+	ShotSpread(0),
+	ShotTraceStart(FVector::ZeroVector),
+	ShotAimDirection(FVector::ForwardVector),
+	// shot replication
+	NextShotBatchTime(0.f),
+	LastServerShotTime(TNumericLimits<float>::Lowest()),
+	ShotTimingTolerance(0.8f),
+	MaxShotTraceStartDistance(500.f),
+	MaxShotsPerBatch(8),
+	ServerShotCredit(8.f),
+	LastShotCreditTime(0.f),
+	LastProcessedShotSequence(0),
+	ServerReloadStartTime(0.f),
 	// crouch
 	bCrouching(false),
 	BaseMovementSpeed(650.f),
@@ -104,6 +143,25 @@ AShooterCharacter::AShooterCharacter() :
 	HandSceneComponent = CreateDefaultSubobject<USceneComponent>(TEXT("HandSceneComp"));
 }
 
+void AShooterCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// Push model, every write goes through a setter that marks the property dirty
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterCharacter, EquippedWeapon, Params);
+
+	Params.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterCharacter, AmmoCounts, Params);
+
+	// The owner runs its own
+	Params.Condition = COND_SkipOwner;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterCharacter, CombatState, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterCharacter, bAiming, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterCharacter, bCrouching, Params);
+}
+
 #pragma region Init
 
 // Called when the game starts or when spawned
@@ -119,6 +177,63 @@ void AShooterCharacter::BeginPlay()
 
 	InitializeAmmoMap();
 	SpawnDefaultWeapon();
+
+	// Avoid first shot / first reload hitches
+	WarmCombatAssets();
+
+	// Server keeps a hitbox history to resolve client shots
+	if (HasAuthority() && GetNetMode() != NM_Standalone)
+	{
+		if (ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>())
+		{
+			LagCompensation->RegisterCharacter(this);
+		}
+	}
+
+	// Remote characters tick and animate less when far or off screen
+	if (GetNetMode() == NM_Client || GetNetMode() == NM_Standalone)
+	{
+		if (UShooterSignificanceManager* SignificanceManager = USignificanceManager::Get<UShooterSignificanceManager>(GetWorld()))
+		{
+			SignificanceManager->RegisterCharacter(this);
+		}
+	}
+}
+
+void AShooterCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>())
+	{
+		LagCompensation->UnregisterCharacter(this);
+	}
+
+	if (UShooterSignificanceManager* SignificanceManager = USignificanceManager::Get<UShooterSignificanceManager>(GetWorld()))
+	{
+		SignificanceManager->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShooterCharacter::WarmCombatAssets()
+{
+	CombatPreloadManifest.AddSound(FireSound);
+	CombatPreloadManifest.AddMontage(HipFireMontage, FName("StartFire"));
+	CombatPreloadManifest.AddParticleSystem(MuzzleFlash);
+	CombatPreloadManifest.AddParticleSystem(BeamParticles);
+	CombatPreloadManifest.AddParticleSystem(ImpactParticles);
+
+	if (EquippedWeapon)
+	{
+		CombatPreloadManifest.AddSound(EquippedWeapon->GetFireSound());
+		CombatPreloadManifest.AddMontage(ReloadMontage, EquippedWeapon->GetReloadMontageSection());
+		CombatPreloadManifest.AddParticleSystem(EquippedWeapon->GetMuzzleFlash());
+		CombatPreloadManifest.AddParticleSystem(EquippedWeapon->GetBeamParticles());
+		CombatPreloadManifest.AddParticleSystem(EquippedWeapon->GetImpactParticles());
+	}
+
+	CombatPreloadManifest.Warm(GetWorld(), FXPrewarmCount);
+	CombatPreloadManifest.LogTimings(GetName());
 }
 #pragma endregion
 
@@ -226,6 +341,7 @@ bool AShooterCharacter::GetBeamEndLocation(
 			FHitResult WeaponTraceHit;
 			const FVector WeaponTraceStart{ MuzzleSocketLocation };
 			const FVector WeaponTraceEnd{ OutBeamEnd };
+			SHOOTER_INC_COUNTER(STAT_ShooterTraces);
 			GetWorld()->LineTraceSingleByChannel(
 				WeaponTraceHit,
 				WeaponTraceStart,
@@ -257,13 +373,31 @@ void AShooterCharacter::StartAim()
 {
 	if (EquippedWeapon)
 	{
-		bAiming = true;
+		SetAiming(true);
 	}
 }
 
 void AShooterCharacter::StopAim()
 {
-	bAiming = false;
+	SetAiming(false);
+}
+
+void AShooterCharacter::SetAiming(bool bNewAiming)
+{
+	if (bAiming == bNewAiming) return;
+
+	bAiming = bNewAiming;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AShooterCharacter, bAiming, this);
+
+	if (!HasAuthority())
+	{
+		ServerSetAiming(bNewAiming);
+	}
+}
+
+void AShooterCharacter::ServerSetAiming_Implementation(bool bNewAiming)
+{
+	SetAiming(bNewAiming && EquippedWeapon != nullptr);
 }
 
 void AShooterCharacter::CameraInterpZoom(float DeltaTime)
@@ -307,6 +441,8 @@ void AShooterCharacter::SetLookRates()
 
 void AShooterCharacter::CalculateCrosshairSpread(float DeltaTime)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterCalculateCrosshairSpread);
+
 	// Move based on speed, set in moveforward
 	/*FVector2D WalkSpeedRange{ 0.f, 600.f };
 	FVector2D VelocityMultiplierRange{ 0.f, 1.f };
@@ -435,12 +571,10 @@ void AShooterCharacter::FireButtonReleased()
 	bFireButtonPressed = false;
 }
 
-bool AShooterCharacter::TraceFromCrosshair(
-	FHitResult& OutHitResult,
-	FVector& OutHitLocation)
+bool AShooterCharacter::GetCrosshairTraceSegment(
+	FVector& OutStart,
+	FVector& OutEnd)
 {
-	bool found = false;
-
 	// Get Viewport Size
 	FVector2D ViewportSize;
 	if (GEngine && GEngine->GameViewport)
@@ -463,10 +597,28 @@ bool AShooterCharacter::TraceFromCrosshair(
 	if (bScreenToWorld) // deproject success
 	{
 		// Trace from Crosshair world location
-		const FVector Start{ CrosshairWorldPosition };
-		const FVector End{ Start + CrosshairWorldDirection * 50'000.f };
+		OutStart = CrosshairWorldPosition;
+		OutEnd = OutStart + CrosshairWorldDirection * 50'000.f;
+	}
+
+	return bScreenToWorld;
+}
+
+bool AShooterCharacter::TraceFromCrosshair(
+	FHitResult& OutHitResult,
+	FVector& OutHitLocation)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterTraceFromCrosshair);
+
+	bool found = false;
+
+	FVector Start;
+	FVector End;
+	if (GetCrosshairTraceSegment(Start, End))
+	{
 		OutHitLocation = End;
 
+		SHOOTER_INC_COUNTER(STAT_ShooterTraces);
 		GetWorld()->LineTraceSingleByChannel(
 			OutHitResult,
 			Start,
@@ -491,31 +643,54 @@ bool AShooterCharacter::TraceFromCrosshair(
 
 void AShooterCharacter::TraceForItems()
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterTraceForItems);
+	FShooterFrameTimingScope FrameTiming(GetWorld(), EShooterFrameTiming::TraceForItems);
+
 	if (bShouldTraceForItems)
 	{
 		// todo collide with character
 
 		// Crosshair trace
 		FHitResult ItemTraceResult;
-		FVector HitLocation;
-		TraceFromCrosshair(ItemTraceResult, HitLocation);
-		if (ItemTraceResult.bBlockingHit)
+		if (CVarShooterAsyncTraces.GetValueOnGameThread())
 		{
-			TraceHitItem = Cast<AItem>(ItemTraceResult.GetActor());
+			// Result of the trace queued last frame
+			FTraceDatum ItemTraceDatum;
+			if (GetWorld()->QueryTraceData(ItemTraceHandle, ItemTraceDatum))
+			{
+				if (const FHitResult* Hit = FHitResult::GetFirstBlockingHit(ItemTraceDatum.OutHits))
+				{
+					ItemTraceResult = *Hit;
+				}
+			}
 
-			if (TraceHitItem)
+			// Queue this frame's trace
+			FVector Start;
+			FVector End;
+			ItemTraceHandle = FTraceHandle();
+			if (GetCrosshairTraceSegment(Start, End))
 			{
-				TraceHitItem->ShowUI();
+				SHOOTER_INC_COUNTER(STAT_ShooterTraces);
+				ItemTraceHandle = GetWorld()->AsyncLineTraceByChannel(
+					EAsyncTraceType::Single,
+					Start,
+					End,
+					ECollisionChannel::ECC_Visibility);
 			}
+		}
+		else
+		{
+			FVector HitLocation;
+			TraceFromCrosshair(ItemTraceResult, HitLocation);
+		}
+		if (ItemTraceResult.bBlockingHit)
+		{
+			TraceHitItem = Cast<AItem>(ItemTraceResult.GetActor());
 
-			if (LastTraceItem)
+			// Moves the shared pickup widget to this item, or hides it
+			if (TraceHitItem != LastTraceItem)
 			{
-				// We are hitting a different AItem this frame from last frame
-				// Or AItem is null.
-				if (TraceHitItem != LastTraceItem)
-				{
-					LastTraceItem->HideUI();
-				}
+				SetFocusedItem(TraceHitItem);
 			}
 
 			LastTraceItem = TraceHitItem;
@@ -526,34 +701,95 @@ void AShooterCharacter::TraceForItems()
 		// Crosshair trace
 		if (LastTraceItem)
 		{
-			LastTraceItem->HideUI();
+			SetFocusedItem(nullptr);
+			LastTraceItem = nullptr;
 		}
 	}
 }
 
+void AShooterCharacter::SetFocusedItem(AItem* Item)
+{
+	if (AShooterPlayerController* PlayerController = Cast<AShooterPlayerController>(GetController()))
+	{
+		PlayerController->SetFocusedItem(Item);
+	}
+}
+
 void AShooterCharacter::SpawnDefaultWeapon()
 {
-	// Check the TSubclassOf variable
-	if (DefaultWeaponClass)
+	// Clients get it through EquippedWeapon
+	if (!HasAuthority()) return;
+
+	// Check the TSoftClassPtr variable
+	if (DefaultWeaponClass.IsNull()) return;
+
+	DefaultWeaponLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		DefaultWeaponClass.ToSoftObjectPath(),
+		FStreamableDelegate::CreateUObject(this, &AShooterCharacter::OnDefaultWeaponClassLoaded));
+}
+
+void AShooterCharacter::OnDefaultWeaponClassLoaded()
+{
+	UClass* WeaponClass = DefaultWeaponClass.Get();
+	if (WeaponClass == nullptr) return;
+
+	// Mesh, FX and sounds of the weapon's definition
+	TArray<FSoftObjectPath> AssetsToLoad;
+	const AWeapon* WeaponDefaults = WeaponClass->GetDefaultObject<AWeapon>();
+	if (WeaponDefaults && WeaponDefaults->GetWeaponData())
 	{
-		AWeapon* DefaultWeapon = GetWorld()->SpawnActor<AWeapon>(DefaultWeaponClass);
-		EquipWeapon(DefaultWeapon);
+		WeaponDefaults->GetWeaponData()->GetAssetsToLoad(AssetsToLoad);
 	}
+	AssetsToLoad.Add(DefaultWeaponClass.ToSoftObjectPath());
+
+	DefaultWeaponLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		AssetsToLoad,
+		FStreamableDelegate::CreateUObject(this, &AShooterCharacter::OnDefaultWeaponAssetsLoaded));
+}
+
+void AShooterCharacter::OnDefaultWeaponAssetsLoaded()
+{
+	// Picked up a weapon while loading
+	if (EquippedWeapon) return;
+
+	UClass* WeaponClass = DefaultWeaponClass.Get();
+	if (WeaponClass == nullptr) return;
+
+	AWeapon* DefaultWeapon = GetWorld()->SpawnActor<AWeapon>(WeaponClass);
+	EquipWeapon(DefaultWeapon);
 }
 
 
 // Called every frame
 void AShooterCharacter::Tick(float DeltaTime)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterCharacterTick);
+	FShooterFrameTimingScope FrameTiming(GetWorld(), EShooterFrameTiming::CharacterTick);
+
 	Super::Tick(DeltaTime);
 
-	CameraInterpZoom(DeltaTime);
+	// Camera, crosshair and item UI only matter to whoever controls this character
+	if (IsLocallyControlled())
+	{
+		CameraInterpZoom(DeltaTime);
 
-	SetLookRates();
+		SetLookRates();
 
-	CalculateCrosshairSpread(DeltaTime);
+		CalculateCrosshairSpread(DeltaTime);
+	}
 
-	TraceForItems();
+	// Item states are the server's, a client only needs its own pickup range
+	if (HasAuthority() || IsLocallyControlled())
+	{
+		UpdateNearbyItems();
+	}
+
+	if (IsLocallyControlled())
+	{
+		TraceForItems();
+	}
+
+	FlushShotBatches();
 }
 
 float AShooterCharacter::GetCrosshairSpreadMultiplier() const
@@ -561,23 +797,47 @@ float AShooterCharacter::GetCrosshairSpreadMultiplier() const
 	return CrosshairSpreadMultiplier;
 }
 
-void AShooterCharacter::AddOverlappedItemCount(int8 Amount)
+void AShooterCharacter::UpdateNearbyItems()
 {
-	OverlappedItemCount += Amount;
-
-	if (OverlappedItemCount > 0)
+	UItemProximitySubsystem* ProximitySubsystem = GetWorld()->GetSubsystem<UItemProximitySubsystem>();
+	if (ProximitySubsystem == nullptr) return;
+
+	// Last frame's list becomes this frame's buffer, neither reallocates once grown
+	Swap(NearbyItems, PreviousNearbyItems);
+	const uint32 QueryId = ProximitySubsystem->QueryItems(
+		GetActorLocation(),
+		GetCapsuleComponent()->GetScaledCapsuleRadius(),
+		NearbyItems);
+
+	// Entered range
+	for (AItem* Item : NearbyItems)
 	{
-		bShouldTraceForItems = true;
+		if (Item->GetItemState() == EItemState::EIS_Idle)
+		{
+			Item->SetItemState(EItemState::EIS_Pickup);
+		}
 	}
-	else
+
+	// Left range, items found by this query carry its id
+	for (AItem* Item : PreviousNearbyItems)
 	{
-		bShouldTraceForItems = false;
-		OverlappedItemCount = 0;
+		if (IsValid(Item) &&
+			Item->GetItemState() == EItemState::EIS_Pickup &&
+			!UItemProximitySubsystem::WasFoundByQuery(Item, QueryId))
+		{
+			Item->SetItemState(EItemState::EIS_Idle);
+		}
 	}
+
+	OverlappedItemCount = NearbyItems.Num();
+	bShouldTraceForItems = OverlappedItemCount > 0;
 }
 
 void AShooterCharacter::AutoPickUpItem(AItem* item)
 {
+	// EquippedWeapon and the weapon's state replicate, a client equipping here would diverge
+	if (!HasAuthority()) return;
+
 	// todo TraceForItems
 	CollisionItem = item;
 
@@ -596,17 +856,67 @@ void AShooterCharacter::EquipWeapon(AWeapon* WeaponToEquip)
 {
 	if (WeaponToEquip)
 	{
-		// Get the Hand Socket
-		const USkeletalMeshSocket* HandSocket = GetMesh()->GetSocketByName(
-			FName("RightHandSocket"));
-		if (HandSocket)
-		{
-			// Attach the Weapon to the hand socket RightHandSocket
-			HandSocket->AttachActor(WeaponToEquip, GetMesh());
-		}
+		// Owner-only replication and RPCs of the weapon
+		WeaponToEquip->SetOwner(this);
+
 		// Set EquippedWeapon to the newly spawned Weapon
 		EquippedWeapon = WeaponToEquip;
-		EquippedWeapon->SetItemState(EItemState::EIS_Equipped);
+		MARK_PROPERTY_DIRTY_FROM_NAME(AShooterCharacter, EquippedWeapon, this);
+		AttachEquippedWeapon();
+
+		// Ammo skips the owner, so a weapon picked up from the floor needs its magazine sent once
+		if (HasAuthority())
+		{
+			AcknowledgeShots();
+		}
+
+		NotifyEquipWeapon.Broadcast(this, EquippedWeapon);
+	}
+}
+
+void AShooterCharacter::AttachEquippedWeapon()
+{
+	if (EquippedWeapon == nullptr) return;
+
+	// Resolve every socket and bone once
+	WeaponRig.Build(GetMesh(), EquippedWeapon);
+
+	// Get the Hand Socket
+	const USkeletalMeshSocket* HandSocket = WeaponRig.RightHandSocket;
+	if (HandSocket)
+	{
+		// Attach the Weapon to the hand socket RightHandSocket
+		HandSocket->AttachActor(EquippedWeapon, GetMesh());
+	}
+	EquippedWeapon->SetItemState(EItemState::EIS_Equipped);
+
+	// Predictions were against the previous weapon's magazine
+	ShotPrediction.Reset();
+
+	// Weapon definition FX and reload section
+	WarmCombatAssets();
+
+	OnEquippedWeaponChanged.Broadcast(EquippedWeapon);
+}
+
+void AShooterCharacter::OnRep_EquippedWeapon(AWeapon* OldWeapon)
+{
+	// Dropped, the server throws it
+	if (OldWeapon && OldWeapon != EquippedWeapon && OldWeapon->GetAttachParentActor() == this)
+	{
+		FDetachmentTransformRules DetachmentTransformRules(EDetachmentRule::KeepWorld, true);
+		OldWeapon->GetItemMesh()->DetachFromComponent(DetachmentTransformRules);
+		OldWeapon->SetItemState(EItemState::EIS_Falling);
+	}
+
+	if (EquippedWeapon)
+	{
+		AttachEquippedWeapon();
+	}
+	else
+	{
+		WeaponRig.Reset();
+		OnEquippedWeaponChanged.Broadcast(nullptr);
 	}
 }
 
@@ -617,13 +927,18 @@ void AShooterCharacter::DropWeapon()
 		FDetachmentTransformRules DetachmentTransformRules(EDetachmentRule::KeepWorld, true);
 		EquippedWeapon->GetItemMesh()->DetachFromComponent(DetachmentTransformRules);
 
-		EquippedWeapon->SetItemState(EItemState::EIS_Falling);
 		EquippedWeapon->ThrowWeapon();
+		EquippedWeapon->SetOwner(nullptr);
+		NotifyUnEquipWeapon.Broadcast(this, EquippedWeapon);
 		EquippedWeapon = nullptr;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AShooterCharacter, EquippedWeapon, this);
+		WeaponRig.Reset();
+		OnEquippedWeaponChanged.Broadcast(nullptr);
 
-		if (CollisionItem)
+		// Weak, the item may have been demoted to a proxy meanwhile
+		if (CollisionItem.IsValid())
 		{
-			auto weapon = Cast<AWeapon>(CollisionItem);
+			auto weapon = Cast<AWeapon>(CollisionItem.Get());
 			if (weapon)
 			{
 				EquipWeapon(weapon);
@@ -635,8 +950,22 @@ void AShooterCharacter::DropWeapon()
 
 }
 
+const FWeaponRigCache& AShooterCharacter::GetWeaponRig()
+{
+	if (EquippedWeapon && !WeaponRig.IsValidFor(EquippedWeapon))
+	{
+		WeaponRig.Build(GetMesh(), EquippedWeapon);
+	}
+	return WeaponRig;
+}
+
 void AShooterCharacter::DropButtonPressed()
 {
+	if (!HasAuthority())
+	{
+		ServerDropWeapon();
+		return;
+	}
 	DropWeapon();
 }
 
@@ -645,6 +974,13 @@ void AShooterCharacter::SelectButtonPressed()
 	if (TraceHitItem)
 	{
 		auto TraceHitWeapon = Cast<AWeapon>(TraceHitItem);
+		if (TraceHitWeapon == nullptr) return;
+
+		if (!HasAuthority())
+		{
+			ServerSwapWeapon(TraceHitWeapon);
+			return;
+		}
 		SwapWeapon(TraceHitWeapon);
 	}
 }
@@ -662,24 +998,61 @@ void AShooterCharacter::SwapWeapon(AWeapon* WeaponToSwap)
 #pragma region Fire weapon
 void AShooterCharacter::FireWeapon()
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterFireWeapon);
+	FShooterFrameTimingScope FrameTiming(GetWorld(), EShooterFrameTiming::FireWeapon);
+
 	if (EquippedWeapon == nullptr) return;
 	if (CombatState != ECombatState::ECS_Unoccupied) return;
 
+	// Too far ahead of the server, wait for its acknowledgements
+	if (!HasAuthority() && ShotPrediction.IsFull()) return;
+
 	if (WeaponHasAmmo())
 	{
+		// Same pellets here and on the server
+		ShotSeed = (uint16)FMath::Rand();
+		ShotSpread = FShotRequest::QuantizeSpread(CrosshairSpreadMultiplier);
+		UpdateShotAim();
+
 		PlayFireSound();
 		SendBullet();
 		PlayGunfireMontage();
 		EquippedWeapon->DecrementAmmo();
 
+		if (GetNetMode() != NM_Standalone)
+		{
+			QueueShotRequest();
+		}
+
 		StartFireTimer();
 	}
 }
 
+void AShooterCharacter::UpdateShotAim()
+{
+	FVector End;
+	if (GetCrosshairTraceSegment(ShotTraceStart, End))
+	{
+		ShotAimDirection = (End - ShotTraceStart).GetSafeNormal();
+		return;
+	}
+
+	// No viewport, e.g. a -nullrhi bot
+	FRotator ViewRotation;
+	GetActorEyesViewPoint(ShotTraceStart, ViewRotation);
+	ShotAimDirection = ViewRotation.Vector();
+}
+
+void AShooterCharacter::SetCombatState(ECombatState State)
+{
+	CombatState = State;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AShooterCharacter, CombatState, this);
+}
+
 void AShooterCharacter::InitializeAmmoMap()
 {
-	AmmoMap.Add(EMyAmmoType::EAT_9mm, Starting9mmAmmo);
-	AmmoMap.Add(EMyAmmoType::EAT_AR, StartingARAmmo);
+	SetCarriedAmmo(EMyAmmoType::EAT_9mm, Starting9mmAmmo);
+	SetCarriedAmmo(EMyAmmoType::EAT_AR, StartingARAmmo);
 }
 
 bool AShooterCharacter::WeaponHasAmmo()
@@ -692,55 +1065,192 @@ bool AShooterCharacter::WeaponHasAmmo()
 void AShooterCharacter::PlayFireSound()
 {
 	// Play fire sound
-	if (FireSound)
+	if (USoundCue* ShotFireSound = GetShotFireSound())
 	{
-		UGameplayStatics::PlaySound2D(this, FireSound);
+		UGameplayStatics::PlaySound2D(this, ShotFireSound);
 	}
 }
 
+USoundCue* AShooterCharacter::GetShotFireSound() const
+{
+	USoundCue* WeaponSound = EquippedWeapon ? EquippedWeapon->GetFireSound() : nullptr;
+	return WeaponSound ? WeaponSound : FireSound;
+}
+
+UParticleSystem* AShooterCharacter::GetShotMuzzleFlash() const
+{
+	UParticleSystem* WeaponFX = EquippedWeapon ? EquippedWeapon->GetMuzzleFlash() : nullptr;
+	return WeaponFX ? WeaponFX : MuzzleFlash;
+}
+
+UParticleSystem* AShooterCharacter::GetShotImpactParticles() const
+{
+	UParticleSystem* WeaponFX = EquippedWeapon ? EquippedWeapon->GetImpactParticles() : nullptr;
+	return WeaponFX ? WeaponFX : ImpactParticles;
+}
+
+UParticleSystem* AShooterCharacter::GetShotBeamParticles() const
+{
+	UParticleSystem* WeaponFX = EquippedWeapon ? EquippedWeapon->GetBeamParticles() : nullptr;
+	return WeaponFX ? WeaponFX : BeamParticles;
+}
+
 void AShooterCharacter::SendBullet()
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterSendBullet);
+
 	// Barrel
-	const USkeletalMeshSocket* BarrelSocket =
-		EquippedWeapon->GetItemMesh()->GetSocketByName("BarrelSocket");
-	if (BarrelSocket)
+	FTransform SocketTransform;
+	if (GetWeaponRig().GetBarrelTransform(SocketTransform))
 	{
+		UCombatFXSubsystem* FXSubsystem = GetWorld()->GetSubsystem<UCombatFXSubsystem>();
+		if (FXSubsystem == nullptr) return;
+
 		// FX: MuzzleFlash + bullet shell
-		const FTransform SocketTransform =
-			BarrelSocket->GetSocketTransform(EquippedWeapon->GetItemMesh());
-		if (MuzzleFlash)
+		FXSubsystem->SpawnAtLocation(GetShotMuzzleFlash(), SocketTransform);
+
+		// Shotgun
+		if (EquippedWeapon->GetPelletCount() > 1)
+		{
+			SendPellets(SocketTransform);
+			return;
+		}
+
+		if (CVarShooterAsyncTraces.GetValueOnGameThread())
 		{
-			UGameplayStatics::SpawnEmitterAtLocation
-			(GetWorld(), MuzzleFlash, SocketTransform);
+			// Beam and impact are spawned when the trace completes
+			FTraceDelegate TraceDelegate = FTraceDelegate::CreateUObject(
+				this,
+				&AShooterCharacter::OnShotCrosshairTraced,
+				SocketTransform);
+			SHOOTER_INC_COUNTER(STAT_ShooterTraces);
+			GetWorld()->AsyncLineTraceByChannel(
+				EAsyncTraceType::Single,
+				ShotTraceStart,
+				ShotTraceStart + ShotAimDirection * 50'000.f,
+				ECollisionChannel::ECC_Visibility,
+				FCollisionQueryParams::DefaultQueryParam,
+				FCollisionResponseParams::DefaultResponseParam,
+				&TraceDelegate);
+			return;
 		}
 
 		// Hit
 		FVector BeamEnd;
 		bool bHit = GetBeamEndLocation(SocketTransform.GetLocation(), BeamEnd);
 
-		// beam
-		UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(
+		SpawnBeamAndImpactFX(SocketTransform, BeamEnd, bHit);
+	}
+}
+
+void AShooterCharacter::SendPellets(const FTransform& SocketTransform)
+{
+	TSharedRef<FHitscanBatch> Batch = MakeShared<FHitscanBatch>();
+	Batch->Start = ShotTraceStart;
+
+	// Pellet cone around the crosshair direction, wider when the crosshair spreads; ResolveShotRequest builds the same one
+	const float ConeHalfAngle{ FMath::DegreesToRadians(
+		EquippedWeapon->GetPelletSpreadAngle() * FShotRequest::DequantizeSpread(ShotSpread)) };
+	Batch->AddConeRays(ShotAimDirection, 50'000.f, ConeHalfAngle, EquippedWeapon->GetPelletCount(), ShotSeed);
+
+	if (CVarShooterAsyncTraces.GetValueOnGameThread())
+	{
+		FHitscanBatch::TraceAsync(
 			GetWorld(),
-			BeamParticles,
-			SocketTransform);
-		if (Beam)
-		{
-			Beam->SetVectorParameter(FName("Target"), BeamEnd);
-		}
+			Batch,
+			FOnHitscanBatchResolved::CreateUObject(
+				this,
+				&AShooterCharacter::OnPelletsResolved,
+				SocketTransform));
+	}
+	else
+	{
+		Batch->TraceSync(GetWorld());
+		OnPelletsResolved(*Batch, SocketTransform);
+	}
+}
 
-		// impact
-		if (bHit)
-		{
-			if (ImpactParticles)
-			{
-				UGameplayStatics::SpawnEmitterAtLocation(
-					GetWorld(),
-					ImpactParticles,
-					BeamEnd);
-			}
-		}
+void AShooterCharacter::OnPelletsResolved(const FHitscanBatch& Batch, FTransform SocketTransform)
+{
+	// One beam and one impact per surface instead of per pellet
+	TArray<FHitscanImpactGroup, TInlineAllocator<16>> ImpactGroups;
+	Batch.GroupImpactsBySurface(ImpactGroups);
+	for (const FHitscanImpactGroup& Group : ImpactGroups)
+	{
+		SpawnBeamAndImpactFX(SocketTransform, Group.Location, Group.bBlockingHit);
+	}
+}
+
+void AShooterCharacter::SpawnBeamAndImpactFX(
+	const FTransform& SocketTransform,
+	const FVector& BeamEnd,
+	bool bHit)
+{
+	UCombatFXSubsystem* FXSubsystem = GetWorld()->GetSubsystem<UCombatFXSubsystem>();
+	if (FXSubsystem == nullptr) return;
+
+	// beam
+	UParticleSystemComponent* Beam = FXSubsystem->SpawnAtLocation(
+		GetShotBeamParticles(),
+		SocketTransform);
+	if (Beam)
+	{
+		Beam->SetVectorParameter(FName("Target"), BeamEnd);
+	}
+
+	// impact
+	if (bHit)
+	{
+		FXSubsystem->SpawnAtLocation(GetShotImpactParticles(), BeamEnd);
+	}
+}
+
+void AShooterCharacter::OnShotCrosshairTraced(
+	const FTraceHandle& TraceHandle,
+	FTraceDatum& TraceDatum,
+	FTransform SocketTransform)
+{
+	const FHitResult* CrosshairHit = FHitResult::GetFirstBlockingHit(TraceDatum.OutHits);
+	if (CrosshairHit == nullptr)
+	{
+		// Missed, beam to the end of the trace
+		SpawnBeamAndImpactFX(SocketTransform, TraceDatum.End, false);
+		return;
+	}
 
+	// Perform a second trace, from the gun barrel
+	if (bUseWeaponTrace)
+	{
+		FTraceDelegate TraceDelegate = FTraceDelegate::CreateUObject(
+			this,
+			&AShooterCharacter::OnShotBarrelTraced,
+			SocketTransform);
+		SHOOTER_INC_COUNTER(STAT_ShooterTraces);
+		GetWorld()->AsyncLineTraceByChannel(
+			EAsyncTraceType::Single,
+			SocketTransform.GetLocation(),
+			CrosshairHit->Location,
+			ECollisionChannel::ECC_Visibility,
+			FCollisionQueryParams::DefaultQueryParam,
+			FCollisionResponseParams::DefaultResponseParam,
+			&TraceDelegate);
+		return;
 	}
+
+	SpawnBeamAndImpactFX(SocketTransform, CrosshairHit->Location, true);
+}
+
+void AShooterCharacter::OnShotBarrelTraced(
+	const FTraceHandle& TraceHandle,
+	FTraceDatum& TraceDatum,
+	FTransform SocketTransform)
+{
+	// Barrel trace ends at the crosshair hit, so the shot always hits
+	const FHitResult* WeaponTraceHit = FHitResult::GetFirstBlockingHit(TraceDatum.OutHits);
+	SpawnBeamAndImpactFX(
+		SocketTransform,
+		WeaponTraceHit ? WeaponTraceHit->Location : TraceDatum.End,
+		true);
 }
 
 void AShooterCharacter::PlayGunfireMontage()
@@ -759,7 +1269,7 @@ void AShooterCharacter::PlayGunfireMontage()
 
 void AShooterCharacter::StartFireTimer()
 {
-	CombatState = ECombatState::ECS_FireTimerInProgress;
+	SetCombatState(ECombatState::ECS_FireTimerInProgress);
 
 	GetWorldTimerManager().SetTimer(
 		AutoFireTimer,
@@ -770,7 +1280,7 @@ void AShooterCharacter::StartFireTimer()
 
 void AShooterCharacter::AutoFireReset()
 {
-	CombatState = ECombatState::ECS_Unoccupied;
+	SetCombatState(ECombatState::ECS_Unoccupied);
 
 	if (WeaponHasAmmo())
 	{
@@ -788,6 +1298,304 @@ void AShooterCharacter::AutoFireReset()
 #pragma endregion
 
 
+#pragma region Shot replication
+void AShooterCharacter::QueueShotRequest()
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+
+	// The crosshair ray FireWeapon already took, the server traces the same one
+	FShotRequest Shot;
+	Shot.TraceStart = ShotTraceStart;
+	Shot.Direction = ShotAimDirection;
+	Shot.Seed = ShotSeed;
+	Shot.Spread = ShotSpread;
+	Shot.ClientTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+	if (HasAuthority())
+	{
+		// Listen server, ammo already taken by FireWeapon
+		ResolveShotRequest(Shot);
+	}
+	else
+	{
+		Shot.Sequence = ShotPrediction.Add();
+		PendingShotRequests.Add(Shot);
+	}
+}
+
+void AShooterCharacter::FlushShotBatches()
+{
+	if (PendingShotRequests.Num() == 0 && PendingShotCosmetics.ShotCount == 0) return;
+
+	// Every shot fired during one net update goes in one RPC
+	const float Now{ GetWorld()->GetTimeSeconds() };
+	if (Now < NextShotBatchTime) return;
+	NextShotBatchTime = Now + 1.f / FMath::Max(NetUpdateFrequency, 1.f);
+
+	// Never more per RPC than the server traces
+	for (int32 First = 0; First < PendingShotRequests.Num(); First += MaxShotsPerBatch)
+	{
+		const int32 Count{ FMath::Min(MaxShotsPerBatch, PendingShotRequests.Num() - First) };
+		ServerFireShots(TArray<FShotRequest>(PendingShotRequests.GetData() + First, Count));
+	}
+	PendingShotRequests.Reset();
+
+	if (PendingShotCosmetics.ShotCount > 0)
+	{
+		MulticastShotCosmetics(PendingShotCosmetics);
+		PendingShotCosmetics = FShotCosmeticBatch();
+	}
+}
+
+bool AShooterCharacter::ValidateShotRequest(const FShotRequest& Shot)
+{
+	if (EquippedWeapon == nullptr || EquippedWeapon->GetAmmo() <= 0) return false;
+	if (CombatState == ECombatState::ECS_Reloading) return false;
+
+	// Fire rate, on the client's clock so batching and latency jitter don't reject shots,
+	// and on the server's, so a client can't bunch shots up by faking its timestamps
+	if (Shot.ClientTime - LastServerShotTime < AutoFirePeriod * ShotTimingTolerance) return false;
+	if (ServerShotCredit < 1.f) return false;
+
+	// Client clock can't run ahead of the server, nor further behind than hitboxes are rewound
+	const float ServerTime{ GetWorld()->GetTimeSeconds() };
+	if (Shot.ClientTime > ServerTime + AutoFirePeriod) return false;
+	const ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>();
+	if (LagCompensation && Shot.ClientTime < ServerTime - LagCompensation->GetMaxRewindTime()) return false;
+
+	// Traced from the client's camera, which hangs off the character
+	return FVector::DistSquared(GetActorLocation(), Shot.TraceStart) <= FMath::Square(MaxShotTraceStartDistance);
+}
+
+float AShooterCharacter::GetMinShotSpreadMultiplier() const
+{
+	// CalculateCrosshairSpread's targets, from what the server knows, minus interpolation slack
+	float SpreadMultiplier{ 1.f };
+	if (GetVelocity().SizeSquared2D() > FMath::Square(10.f))
+	{
+		SpreadMultiplier += 1.5f;
+	}
+	if (GetCharacterMovement()->IsFalling())
+	{
+		SpreadMultiplier += 2.25f;
+	}
+	if (bAiming)
+	{
+		SpreadMultiplier -= 0.6f;
+	}
+	return SpreadMultiplier * ShotTimingTolerance;
+}
+
+void AShooterCharacter::ResolveShotRequest(const FShotRequest& Shot)
+{
+	if (EquippedWeapon == nullptr) return;
+
+	FHitscanBatch Batch;
+	Batch.Start = Shot.TraceStart;
+	Batch.QueryParams.AddIgnoredActor(this);
+	Batch.QueryParams.AddIgnoredActor(EquippedWeapon);
+
+	if (EquippedWeapon->GetPelletCount() > 1)
+	{
+		// Same cone as SendPellets, but never tighter than the character's state allows
+		const float SpreadMultiplier{ FMath::Max(Shot.GetSpreadMultiplier(), GetMinShotSpreadMultiplier()) };
+		const float ConeHalfAngle{ FMath::DegreesToRadians(EquippedWeapon->GetPelletSpreadAngle() * SpreadMultiplier) };
+		Batch.AddConeRays(Shot.Direction, 50'000.f, ConeHalfAngle, EquippedWeapon->GetPelletCount(), Shot.Seed);
+	}
+	else
+	{
+		// One ray, TraceSync makes it a single plain line trace
+		Batch.Ends.Add(Shot.TraceStart + Shot.Direction * 50'000.f);
+	}
+
+	// Characters where they were when the client fired, the world as it is now
+	ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>();
+	if (LagCompensation)
+	{
+		LagCompensation->AddIgnoredCharacters(Batch.QueryParams);
+	}
+	Batch.TraceSync(GetWorld());
+
+	if (LagCompensation)
+	{
+		for (int32 Index = 0; Index < Batch.Ends.Num(); ++Index)
+		{
+			FHitResult& Hit = Batch.Hits[Index];
+			FLagCompensatedHit CharacterHit;
+			if (!LagCompensation->TraceCharacters(Batch.Start, Batch.Ends[Index], Shot.ClientTime, this, CharacterHit)) continue;
+			if (Hit.bBlockingHit && Hit.Distance <= CharacterHit.Distance) continue;
+
+			Hit = FHitResult(CharacterHit.Character, CharacterHit.Character->GetCapsuleComponent(), CharacterHit.Location, CharacterHit.Normal);
+			Hit.ImpactPoint = CharacterHit.Location;
+			Hit.Distance = CharacterHit.Distance;
+			Hit.TraceStart = Batch.Start;
+			Hit.TraceEnd = Batch.Ends[Index];
+		}
+	}
+
+	// Pellets on the same surface share one impact
+	TArray<FHitscanImpactGroup, TInlineAllocator<16>> ImpactGroups;
+	Batch.GroupImpactsBySurface(ImpactGroups);
+	for (const FHitscanImpactGroup& Group : ImpactGroups)
+	{
+		FShotImpact& Impact = PendingShotCosmetics.Impacts.AddDefaulted_GetRef();
+		Impact.Location = Group.Location;
+		Impact.bBlockingHit = Group.bBlockingHit;
+	}
+	if (PendingShotCosmetics.ShotCount < MAX_uint8)
+	{
+		PendingShotCosmetics.ShotCount++;
+	}
+}
+
+void AShooterCharacter::ServerFireShots_Implementation(const TArray<FShotRequest>& Shots)
+{
+	if (Shots.Num() == 0) return;
+
+	// One shot per fire period since the last RPC, up to a batch after a pause
+	const float Now{ GetWorld()->GetTimeSeconds() };
+	ServerShotCredit = FMath::Min(
+		ServerShotCredit + (Now - LastShotCreditTime) / (AutoFirePeriod * ShotTimingTolerance),
+		(float)MaxShotsPerBatch);
+	LastShotCreditTime = Now;
+
+	// Shots past MaxShotsPerBatch are rejected unseen
+	const int32 NumShots{ FMath::Min(Shots.Num(), MaxShotsPerBatch) };
+	for (int32 Index = 0; Index < NumShots; ++Index)
+	{
+		const FShotRequest& Shot = Shots[Index];
+		if (!ValidateShotRequest(Shot))
+		{
+			SHOOTER_INC_COUNTER(STAT_ShooterRejectedShots);
+			UE_LOG(LogShooter, Verbose, TEXT("%s: rejected shot at %.3f"), *GetName(), Shot.ClientTime);
+			continue;
+		}
+
+		LastServerShotTime = Shot.ClientTime;
+		ServerShotCredit -= 1.f;
+		EquippedWeapon->DecrementAmmo();
+		ResolveShotRequest(Shot);
+	}
+	LastProcessedShotSequence = Shots.Last().Sequence;
+
+	AcknowledgeShots();
+}
+
+void AShooterCharacter::MulticastShotCosmetics_Implementation(const FShotCosmeticBatch& Batch)
+{
+	// The owner already played its shots, a dedicated server has nothing to show
+	if (IsLocallyControlled() || GetNetMode() == NM_DedicatedServer) return;
+
+	FTransform SocketTransform;
+	if (!GetWeaponRig().GetBarrelTransform(SocketTransform)) return;
+
+	UCombatFXSubsystem* FXSubsystem = GetWorld()->GetSubsystem<UCombatFXSubsystem>();
+	if (FXSubsystem == nullptr) return;
+
+	// One flash, sound and montage per batch, shots of one net update are indistinguishable
+	FXSubsystem->SpawnAtLocation(GetShotMuzzleFlash(), SocketTransform);
+	if (USoundCue* ShotFireSound = GetShotFireSound())
+	{
+		UGameplayStatics::PlaySoundAtLocation(this, ShotFireSound, SocketTransform.GetLocation());
+	}
+	PlayGunfireMontage();
+
+	for (const FShotImpact& Impact : Batch.Impacts)
+	{
+		SpawnBeamAndImpactFX(SocketTransform, Impact.Location, Impact.bBlockingHit);
+	}
+}
+
+void AShooterCharacter::AcknowledgeShots()
+{
+	// Nobody predicting
+	if (IsLocallyControlled() || GetNetConnection() == nullptr) return;
+
+	ClientAckShots(LastProcessedShotSequence, EquippedWeapon, EquippedWeapon ? EquippedWeapon->GetAmmo() : 0);
+}
+
+void AShooterCharacter::ClientAckShots_Implementation(uint16 AckedSequence, AWeapon* Weapon, int32 AuthoritativeAmmo)
+{
+	ShotPrediction.Acknowledge(AckedSequence);
+	if (Weapon == nullptr) return;
+
+	if (Weapon == EquippedWeapon)
+	{
+		// Same value as the prediction unless the server rejected something, so no HUD pop
+		const int32 ReplayedAmmo{ ShotPrediction.Replay(AuthoritativeAmmo) };
+		if (ReplayedAmmo != Weapon->GetAmmo())
+		{
+			SHOOTER_INC_COUNTER(STAT_ShooterPredictionCorrections);
+		}
+		Weapon->SetAmmo(ReplayedAmmo);
+	}
+	else
+	{
+		// Just dropped, or picked up and EquippedWeapon not replicated yet; nothing predicted on it
+		Weapon->SetAmmo(AuthoritativeAmmo);
+	}
+}
+
+void AShooterCharacter::ServerReloadWeapon_Implementation()
+{
+	ReloadWeapon();
+}
+
+void AShooterCharacter::ServerFinishReloading_Implementation(uint16 Sequence)
+{
+	LastProcessedShotSequence = Sequence;
+
+	if (CombatState == ECombatState::ECS_Reloading && EquippedWeapon && ReloadMontage)
+	{
+		// Client and server montages start and end half a round trip apart, so only jitter shortens it
+		const int32 SectionIndex = CombatPreloadManifest.FindMontageSectionIndex(
+			ReloadMontage, EquippedWeapon->GetReloadMontageSection());
+		const float MinReloadTime = SectionIndex != INDEX_NONE ?
+			ReloadMontage->GetSectionLength(SectionIndex) * ShotTimingTolerance : 0.f;
+
+		const float RemainingReloadTime{ ServerReloadStartTime + MinReloadTime - GetWorld()->GetTimeSeconds() };
+		if (RemainingReloadTime > 0.f)
+		{
+			// Too early, finish at the earliest allowed time and correct the client then
+			UE_LOG(LogShooter, Verbose, TEXT("%s: early reload delayed by %.3f"), *GetName(), RemainingReloadTime);
+			GetWorldTimerManager().SetTimer(
+				ServerReloadTimer,
+				this,
+				&AShooterCharacter::ServerCompleteReload,
+				RemainingReloadTime);
+			return;
+		}
+
+		ReloadMagazine();
+	}
+
+	AcknowledgeShots();
+}
+
+void AShooterCharacter::ServerCompleteReload()
+{
+	// Already finished
+	if (CombatState != ECombatState::ECS_Reloading) return;
+
+	ReloadMagazine();
+	AcknowledgeShots();
+}
+
+void AShooterCharacter::ServerDropWeapon_Implementation()
+{
+	DropWeapon();
+}
+
+void AShooterCharacter::ServerSwapWeapon_Implementation(AWeapon* WeaponToSwap)
+{
+	// Only pickups in range of this character
+	if (WeaponToSwap == nullptr || !NearbyItems.Contains(WeaponToSwap)) return;
+
+	SwapWeapon(WeaponToSwap);
+}
+#pragma endregion
+
+
 #pragma region Reload
 void AShooterCharacter::ReloadButtonPressed()
 {
@@ -800,7 +1608,17 @@ void AShooterCharacter::ReloadWeapon()
 
 	if (CarryingAmmo())
 	{
-		CombatState = ECombatState::ECS_Reloading;
+		SetCombatState(ECombatState::ECS_Reloading);
+
+		// Predicted, the montage plays on both
+		if (HasAuthority())
+		{
+			ServerReloadStartTime = GetWorld()->GetTimeSeconds();
+		}
+		else if (IsLocallyControlled())
+		{
+			ServerReloadWeapon();
+		}
 
 		UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
 		if (AnimInstance && ReloadMontage)
@@ -817,51 +1635,77 @@ bool AShooterCharacter::CarryingAmmo()
 {
 	if (EquippedWeapon == nullptr) return false;
 
-	auto AmmoType = EquippedWeapon->GetAmmoType();
+	return GetCarriedAmmo(EquippedWeapon->GetAmmoType()) > 0;
+}
 
-	if (AmmoMap.Contains(AmmoType))
+void AShooterCharacter::FinishReloading()
+{
+	// A remote player's reload completes when its client says so, see ServerFinishReloading
+	if (!IsLocallyControlled()) return;
+
+	ReloadMagazine();
+
+	if (!HasAuthority() && EquippedWeapon)
 	{
-		return AmmoMap[AmmoType] > 0;
+		// The reload sets the magazine outright, so older predictions can go if there's no room
+		if (ShotPrediction.IsFull())
+		{
+			ShotPrediction.Reset();
+		}
+		ServerFinishReloading(ShotPrediction.Add(EquippedWeapon->GetAmmo()));
 	}
-
-	return false;
 }
 
-void AShooterCharacter::FinishReloading()
+void AShooterCharacter::ReloadMagazine()
 {
-	CombatState = ECombatState::ECS_Unoccupied;
+	SetCombatState(ECombatState::ECS_Unoccupied);
 
-	// Update AmmoMap
+	// Update AmmoCounts
 	if (EquippedWeapon == nullptr) return;
 	const auto AmmoType{ EquippedWeapon->GetAmmoType() };
 
-	// Update the AmmoMap
-	if (AmmoMap.Contains(AmmoType))
-	{
-		// Amount of ammo the Character is carrying of the EquippedWeapon type
-		int32 CarriedAmmo = AmmoMap[AmmoType];
+	// Amount of ammo the Character is carrying of the EquippedWeapon type
+	int32 CarriedAmmo = GetCarriedAmmo(AmmoType);
 
-		// Space left in the magazine of EquippedWeapon
-		const int32 MagEmptySpace =
-			EquippedWeapon->GetMagazineCapacity() -
-			EquippedWeapon->GetAmmo();
+	// Space left in the magazine of EquippedWeapon
+	const int32 MagEmptySpace =
+		EquippedWeapon->GetMagazineCapacity() -
+		EquippedWeapon->GetAmmo();
 
-		if (MagEmptySpace > CarriedAmmo)
-		{
-			// Reload the magazine with all the ammo we are carrying
-			EquippedWeapon->ReloadAmmo(CarriedAmmo);
-			CarriedAmmo = 0;
-			AmmoMap.Add(AmmoType, CarriedAmmo);
-		}
-		else
-		{
-			// fill the magazine
-			EquippedWeapon->ReloadAmmo(MagEmptySpace);
-			CarriedAmmo -= MagEmptySpace;
-			AmmoMap.Add(AmmoType, CarriedAmmo);
-		}
+	if (MagEmptySpace > CarriedAmmo)
+	{
+		// Reload the magazine with all the ammo we are carrying
+		EquippedWeapon->ReloadAmmo(CarriedAmmo);
+		CarriedAmmo = 0;
+	}
+	else
+	{
+		// fill the magazine
+		EquippedWeapon->ReloadAmmo(MagEmptySpace);
+		CarriedAmmo -= MagEmptySpace;
 	}
+	SetCarriedAmmo(AmmoType, CarriedAmmo);
+}
+
+int32 AShooterCharacter::GetCarriedAmmo(EMyAmmoType AmmoType) const
+{
+	return AmmoCounts.Get(AmmoType);
+}
+
+void AShooterCharacter::SetCarriedAmmo(EMyAmmoType AmmoType, int32 Count)
+{
+	AmmoCounts.Set(AmmoType, Count);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AShooterCharacter, AmmoCounts, this);
+
+	OnCarriedAmmoChanged.Broadcast(AmmoType, AmmoCounts.Get(AmmoType));
+}
 
+void AShooterCharacter::OnRep_AmmoCounts()
+{
+	for (int32 Index = 0; Index < (int32)EMyAmmoType::EAT_NAX; ++Index)
+	{
+		OnCarriedAmmoChanged.Broadcast((EMyAmmoType)Index, AmmoCounts.Get((EMyAmmoType)Index));
+	}
 }
 
 #pragma endregion
@@ -916,12 +1760,12 @@ void AShooterCharacter::GrabClip()
 	if (HandSceneComponent == nullptr) return;
 
 	// Index for the clip bone on the Equipped Weapon
-	int32 ClipBoneIndex{ EquippedWeapon->GetItemMesh()->GetBoneIndex(EquippedWeapon->GetClipBoneName()) };
+	const int32 ClipBoneIndex{ GetWeaponRig().ClipBoneIndex };
 	// Store the transform of the clip
 	ClipTransform = EquippedWeapon->GetItemMesh()->GetBoneTransform(ClipBoneIndex);
 
 	FAttachmentTransformRules AttachmentRules(EAttachmentRule::KeepRelative, true);
-	HandSceneComponent->AttachToComponent(GetMesh(), AttachmentRules, FName(TEXT("Hand_L")));
+	HandSceneComponent->AttachToComponent(GetMesh(), AttachmentRules, FWeaponRigCache::LeftHandBoneName);
 	HandSceneComponent->SetWorldTransform(ClipTransform);
 
 	EquippedWeapon->SetMovingClip(true);
@@ -938,7 +1782,19 @@ void AShooterCharacter::CrouchButtonPressed()
 {
 	if (!GetCharacterMovement()->IsFalling())
 	{
-		bCrouching = !bCrouching;
+		SetCrouching(!bCrouching);
+	}
+}
+
+void AShooterCharacter::SetCrouching(bool bNewCrouching)
+{
+	bCrouching = bNewCrouching;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AShooterCharacter, bCrouching, this);
+
+	// Server moves the character too
+	if (!HasAuthority())
+	{
+		ServerSetCrouching(bNewCrouching);
 	}
 
 	if (bCrouching)
@@ -953,4 +1809,9 @@ void AShooterCharacter::CrouchButtonPressed()
 	}
 }
 
+void AShooterCharacter::ServerSetCrouching_Implementation(bool bNewCrouching)
+{
+	SetCrouching(bNewCrouching);
+}
+
 #pragma endregion
@@ -5,8 +5,20 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "MyAmmoType.h"
+#include "WorldCollision.h"
+#include "Engine/StreamableManager.h"
+#include "CombatPreloadManifest.h"
+#include "WeaponRigCache.h"
+#include "ShotReplication.h"
+#include "ShooterAmmoCounts.h"
 #include "ShooterCharacter.generated.h"
 
+class AWeapon;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnEquippedWeaponChanged, AWeapon* /*EquippedWeapon*/);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnCarriedAmmoChanged, EMyAmmoType /*AmmoType*/, int32 /*CarriedAmmo*/);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnShooterCharacterWeapon, class AShooterCharacter* /*Character*/, AWeapon* /*Weapon*/);
+
 UENUM(BlueprintType)
 enum class ECombatState : uint8
 {
@@ -22,12 +34,21 @@ class SHOOTER_API AShooterCharacter : public ACharacter
 {
 	GENERATED_BODY()
 
+	/** Calls the input handlers on headless load-test clients */
+	friend class UShooterInputBotComponent;
+
+	/** Runs the combat actions directly in the benchmarks */
+	friend class AShooterGameModeBase;
+
 public:
 	// Sets default values for this character's properties
 	AShooterCharacter();
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	void MoveForward(float value);
 	void MoveRight(float value);
@@ -47,6 +68,12 @@ protected:
 	void StartAim();
 	void StopAim();
 
+	/** Sets bAiming locally and on the server, which replicates it to the other clients */
+	void SetAiming(bool bNewAiming);
+
+	UFUNCTION(Server, Reliable)
+	void ServerSetAiming(bool bNewAiming);
+
 	void CameraInterpZoom(float DeltaTime);
 	void SetLookRates();
 
@@ -121,13 +148,23 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 		UParticleSystem* BeamParticles;
 
+	/** Pooled components created per FX template in BeginPlay */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+		int32 FXPrewarmCount;
+
+	/** Combat assets of the character and its equipped weapon, warmed before first use */
+	FCombatPreloadManifest CombatPreloadManifest;
+
+	/** Adds the character's and equipped weapon's combat assets to the manifest and warms the new ones */
+	void WarmCombatAssets();
+
 	// use RPG camera
 	bool bIsFreeCamera = false;
 	// trace from muzzle instead of screen center
 	bool bUseWeaponTrace = false;
 
 	// aim
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Replicated, Category = Combat, meta = (AllowPrivateAccess = "true"))
 		bool bAiming;
 	float CameraDefaultFOV;
 	float CameraZoomedFOV;
@@ -182,29 +219,70 @@ private:
 	bool TraceFromCrosshair(FHitResult& OutHitResult, FVector& OutHitLocation);
 	void TraceForItems();
 
+	/** Points the controller's pickup widget at Item, null hides it */
+	void SetFocusedItem(class AItem* Item);
+
+	/** Start and end of the crosshair trace, false if the screen center could not be deprojected */
+	bool GetCrosshairTraceSegment(FVector& OutStart, FVector& OutEnd);
+
+	/** Async item trace queued last frame */
+	FTraceHandle ItemTraceHandle;
+
 	bool bShouldTraceForItems;
-	int8 OverlappedItemCount;
+	int32 OverlappedItemCount;
+
+	/** Finds pickups in range through UItemProximitySubsystem and moves them between Idle and Pickup */
+	void UpdateNearbyItems();
+
+	/** Items in pickup range last frame */
+	UPROPERTY()
+		TArray<AItem*> NearbyItems;
+
+	/** The frame before, kept as UpdateNearbyItems' second buffer */
+	UPROPERTY()
+		TArray<AItem*> PreviousNearbyItems;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 		class AItem* LastTraceItem;
 	/** The item currently hit by our trace in TraceForItems (could be null) */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
 		AItem* TraceHitItem;
-	AItem* CollisionItem;
+	/** Last item the character auto-picked up against, equipped after a drop */
+	TWeakObjectPtr<AItem> CollisionItem;
 
 	// weapon
 	void SpawnDefaultWeapon();
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	/** Default weapon class is loaded, stream in the assets of its definition */
+	void OnDefaultWeaponClassLoaded();
+	/** Default weapon class and assets are loaded, spawn and equip it */
+	void OnDefaultWeaponAssetsLoaded();
+
+	/** Keeps the default weapon's class and assets loaded */
+	TSharedPtr<FStreamableHandle> DefaultWeaponLoadHandle;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_EquippedWeapon, Category = Combat, meta = (AllowPrivateAccess = "true"))
 		class AWeapon* EquippedWeapon;
 
-	// for spawn weapon
+	UFUNCTION()
+	void OnRep_EquippedWeapon(AWeapon* OldWeapon);
+
+	/** Attaches EquippedWeapon to the hand, on the server and on clients when it replicates */
+	void AttachEquippedWeapon();
+
+	// for spawn weapon, loaded asynchronously in BeginPlay
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
-		TSubclassOf<AWeapon> DefaultWeaponClass;
+		TSoftClassPtr<AWeapon> DefaultWeaponClass;
 
 	void EquipWeapon(AWeapon* WeaponToEquip);
 	void DropWeapon();
 
+	/** Sockets and bones of the equipped weapon, built in EquipWeapon, reset in DropWeapon */
+	FWeaponRigCache WeaponRig;
+
+	/** WeaponRig, rebuilt if the weapon's mesh changed since it was built (e.g. streamed in late) */
+	const FWeaponRigCache& GetWeaponRig();
+
 	void DropButtonPressed();
 	void SelectButtonPressed();
 	void SelectButtonReleased();
@@ -224,12 +302,29 @@ public:
 	UFUNCTION(BlueprintCallable)
 		float GetCrosshairSpreadMultiplier() const;
 
-	//UFUNCTION(BlueprintCallable)
-	//FORCEINLINE AWeapon* GetEquippedWeapon() const { return EquippedWeapon; };
+	FORCEINLINE AWeapon* GetEquippedWeapon() const { return EquippedWeapon; };
+
+	FORCEINLINE float GetAutoFirePeriod() const { return AutoFirePeriod; }
+
+	/** Ammo of AmmoType the character carries, outside of the equipped weapon's magazine */
+	UFUNCTION(BlueprintCallable)
+	int32 GetCarriedAmmo(EMyAmmoType AmmoType) const;
+
+	/** Broadcast by EquipWeapon and DropWeapon, with null when dropping */
+	FOnEquippedWeaponChanged OnEquippedWeaponChanged;
+
+	/** Broadcast when AmmoCounts changes */
+	FOnCarriedAmmoChanged OnCarriedAmmoChanged;
+
+	/**
+	 * Any character equipping / dropping a weapon, in every world and net mode EquipWeapon / DropWeapon
+	 * run in (clients too, and every PIE instance); listeners filter by world. See UShooterReplicationGraph.
+	 */
+	static FOnShooterCharacterWeapon NotifyEquipWeapon;
+	static FOnShooterCharacterWeapon NotifyUnEquipWeapon;
 
 	// pick up item
-	FORCEINLINE int8 GetOverlappedItemCount() const { return OverlappedItemCount; }
-	void AddOverlappedItemCount(int8 Amount);
+	FORCEINLINE int32 GetOverlappedItemCount() const { return OverlappedItemCount; }
 
 	void AutoPickUpItem(AItem* item);
 #pragma endregion
@@ -241,9 +336,15 @@ protected:
 
 private:
 
-	/** Map to keep track of ammo of the different ammo types */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
-		TMap<EMyAmmoType, int32> AmmoMap;
+	/** Carried ammo of the different ammo types, replicated to the owner */
+	UPROPERTY(VisibleAnywhere, ReplicatedUsing = OnRep_AmmoCounts, Category = Items, meta = (AllowPrivateAccess = "true"))
+		FShooterAmmoCounts AmmoCounts;
+
+	UFUNCTION()
+	void OnRep_AmmoCounts();
+
+	/** Sets the carried ammo of AmmoType and marks AmmoCounts dirty */
+	void SetCarriedAmmo(EMyAmmoType AmmoType, int32 Count);
 
 	/** Starting amount of 9mm ammo */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Items, meta = (AllowPrivateAccess = "true"))
@@ -253,10 +354,13 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Items, meta = (AllowPrivateAccess = "true"))
 		int32 StartingARAmmo;
 
-	/** Combat State, can only fire or reload if Unoccupied */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	/** Combat State, can only fire or reload if Unoccupied. The owner runs its own */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Replicated, Category = Combat, meta = (AllowPrivateAccess = "true"))
 		ECombatState CombatState;
 
+	/** Sets CombatState and marks it dirty */
+	void SetCombatState(ECombatState State);
+
 	/** Initialize the Ammo Map with ammo values */
 	void InitializeAmmoMap();
 
@@ -265,15 +369,128 @@ private:
 
 	void PlayFireSound();
 
+	/** Equipped weapon's definition FX / sound if it has them, otherwise the character defaults */
+	class USoundCue* GetShotFireSound() const;
+	UParticleSystem* GetShotMuzzleFlash() const;
+	UParticleSystem* GetShotImpactParticles() const;
+	UParticleSystem* GetShotBeamParticles() const;
+
 	void SendBullet();
 
+	/** Beam from the barrel to BeamEnd, impact if the shot hit something */
+	void SpawnBeamAndImpactFX(const FTransform& SocketTransform, const FVector& BeamEnd, bool bHit);
+
+	/** Fires one ray per pellet of the equipped weapon as a single hitscan batch */
+	void SendPellets(const FTransform& SocketTransform);
+	void OnPelletsResolved(const struct FHitscanBatch& Batch, FTransform SocketTransform);
+
+	// async shot traces
+	void OnShotCrosshairTraced(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum, FTransform SocketTransform);
+	void OnShotBarrelTraced(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum, FTransform SocketTransform);
+
 	void PlayGunfireMontage();
 
+	/** Seed and quantized spread of the current shot, shared by the local pellets and the server request */
+	uint16 ShotSeed;
+	uint8 ShotSpread;
+
+	/** Crosshair ray of the current shot, shared by the local pellets and the server request */
+	FVector ShotTraceStart;
+	FVector ShotAimDirection;
+
+	/** Sets ShotTraceStart / ShotAimDirection from the crosshair, or the view point without a viewport */
+	void UpdateShotAim();
+
 public:
 
 #pragma endregion
 
 
+#pragma region Shot replication
+private:
+	/** Shot requests not sent to the server yet */
+	TArray<FShotRequest> PendingShotRequests;
+
+	/** Resolved shots not sent to the other clients yet */
+	FShotCosmeticBatch PendingShotCosmetics;
+
+	/** Requests and cosmetics are sent at most once per net update */
+	float NextShotBatchTime;
+
+	/** Client time of the last shot the server accepted */
+	float LastServerShotTime;
+
+	/** Fraction of AutoFirePeriod accepted between two shots, absorbs client frame timing */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+		float ShotTimingTolerance;
+
+	/** Distance from the character above which a shot's trace start is rejected, covers the camera boom and latency */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+		float MaxShotTraceStartDistance;
+
+	/** Shots per ServerFireShots, the client splits bigger batches and the server drops the excess */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+		int32 MaxShotsPerBatch;
+
+	/** Server: shots the client may still fire, refilled at the fire rate on the server's clock, capped at MaxShotsPerBatch */
+	float ServerShotCredit;
+	float LastShotCreditTime;
+
+	/** Smallest crosshair spread the character's replicated state allows, shot requests are held to it */
+	float GetMinShotSpreadMultiplier() const;
+
+	/** Owning client: shots and reloads applied locally that the server has not acknowledged yet */
+	FShotPredictionBuffer ShotPrediction;
+
+	/** Server: sequence of the client's last shot / reload, accepted or not */
+	uint16 LastProcessedShotSequence;
+
+	/** Server: when the current reload started, a client can't finish it much sooner than the montage */
+	float ServerReloadStartTime;
+
+	/** Server: completes a reload the client finished too early, at the earliest time it could have */
+	FTimerHandle ServerReloadTimer;
+	void ServerCompleteReload();
+
+	/** Queues the current shot for the server, or resolves it right away on a listen server */
+	void QueueShotRequest();
+
+	/** Sends the pending requests / cosmetics if a net update elapsed */
+	void FlushShotBatches();
+
+	bool ValidateShotRequest(const FShotRequest& Shot);
+
+	/** Traces the shot on the server and queues its impacts for the other clients */
+	void ResolveShotRequest(const FShotRequest& Shot);
+
+	UFUNCTION(Server, Reliable)
+	void ServerFireShots(const TArray<FShotRequest>& Shots);
+
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastShotCosmetics(const FShotCosmeticBatch& Batch);
+
+	/** Server: sends the owning client its magazine as of its last processed action */
+	void AcknowledgeShots();
+
+	/** Drops the acknowledged predictions and replays the rest on top of AuthoritativeAmmo */
+	UFUNCTION(Client, Reliable)
+	void ClientAckShots(uint16 AckedSequence, AWeapon* Weapon, int32 AuthoritativeAmmo);
+
+	/** Sent in order with ServerFireShots so the server reloads between the same shots the client did */
+	UFUNCTION(Server, Reliable)
+	void ServerFinishReloading(uint16 Sequence);
+
+	UFUNCTION(Server, Reliable)
+	void ServerReloadWeapon();
+
+	UFUNCTION(Server, Reliable)
+	void ServerDropWeapon();
+
+	UFUNCTION(Server, Reliable)
+	void ServerSwapWeapon(AWeapon* WeaponToSwap);
+#pragma endregion
+
+
 #pragma region Reload
 	protected:
 	void ReloadButtonPressed();
@@ -292,6 +509,9 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void FinishReloading();
 
+	/** Moves carried ammo into the magazine */
+	void ReloadMagazine();
+
 	/** Transform of the clip when we first grab the clip during reloading */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	FTransform ClipTransform;
@@ -307,7 +527,7 @@ public:
 
 #pragma region Crouch
 			private:
-				UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
+				UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Replicated, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	bool bCrouching;
 
 	/** Regular movement speed */
@@ -340,6 +560,12 @@ public:
 	protected:
 		void CrouchButtonPressed();
 
+		/** Sets bCrouching and the movement settings for it, locally and on the server */
+		void SetCrouching(bool bNewCrouching);
+
+		UFUNCTION(Server, Reliable)
+		void ServerSetCrouching(bool bNewCrouching);
+
 	public:
 		FORCEINLINE bool GetCrouching() const { return bCrouching; }
 #pragma endregion
@@ -2,4 +2,641 @@
 
 
 #include "ShooterGameModeBase.h"
+#include "Shooter.h"
+#include "ShooterCharacter.h"
+#include "ShooterBenchmark.h"
+#include "ShooterBenchmarkSubsystem.h"
+#include "Item.h"
+#include "Weapon.h"
+#include "ShotReplication.h"
+#include "HitscanBatch.h"
+#include "ItemProximitySubsystem.h"
+#include "WeaponRigCache.h"
+#include "LagCompensationSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMeshSocket.h"
+#include "UObject/CoreNet.h"
+#include "AIController.h"
 
+AShooterGameModeBase::AShooterGameModeBase() :
+	StressSpawnSpacing(300.f)
+{
+}
+
+#pragma region Stress
+void AShooterGameModeBase::ShooterSpawnStressActors(int32 NumCharacters, int32 NumItems)
+{
+	const FVector Origin{ ShooterBenchmark::GetSpawnOrigin(GetWorld()) };
+
+	if (const AShooterCharacter* CharacterDefaults = GetStressCharacterDefaults())
+	{
+		SpawnStressGrid(CharacterDefaults->GetClass(), NumCharacters, Origin);
+	}
+	if (StressItemClass)
+	{
+		// Items on the ground, offset from the characters
+		SpawnStressGrid(StressItemClass, NumItems, Origin + FVector(0.f, 0.f, -50.f));
+	}
+
+	CSV_EVENT(Shooter, TEXT("SpawnStressActors %d characters %d items"), NumCharacters, NumItems);
+	UE_LOG(LogShooter, Log, TEXT("Stress actors: %d"), StressActors.Num());
+}
+
+void AShooterGameModeBase::ShooterClearStressActors()
+{
+	for (AActor* Actor : StressActors)
+	{
+		if (IsValid(Actor))
+		{
+			Actor->Destroy();
+		}
+	}
+	StressActors.Reset();
+
+	CSV_EVENT(Shooter, TEXT("ClearStressActors"));
+}
+
+void AShooterGameModeBase::ShooterBenchmarkItemStates(int32 NumItems, int32 Rounds)
+{
+	FShooterBenchmarkReport& Report = BeginBenchmarkReport(TEXT("ItemStates"));
+	if (StressItemClass == nullptr || NumItems <= 0 || Rounds <= 0)
+	{
+		Report.AddError(TEXT("Needs StressItemClass"));
+		return;
+	}
+
+	const int32 FirstItem{ StressActors.Num() };
+	SpawnStressGrid(StressItemClass, NumItems, ShooterBenchmark::GetSpawnOrigin(GetWorld()));
+
+	TArray<AItem*> Items;
+	Items.Reserve(StressActors.Num() - FirstItem);
+	for (int32 Index = FirstItem; Index < StressActors.Num(); ++Index)
+	{
+		if (AItem* Item = Cast<AItem>(StressActors[Index]))
+		{
+			Items.Add(Item);
+		}
+	}
+
+	const EItemState States[] = { EItemState::EIS_Pickup, EItemState::EIS_Falling, EItemState::EIS_Idle };
+	FShooterBenchmarkSamples* Transitions[] = {
+		&Report.AddCase(TEXT("Idle -> Pickup, per item"), Rounds),
+		&Report.AddCase(TEXT("Pickup -> Falling, per item"), Rounds),
+		&Report.AddCase(TEXT("Falling -> Idle, per item"), Rounds) };
+
+	for (int32 Round = 0; Round < Rounds && Items.Num() > 0; ++Round)
+	{
+		for (int32 StateIndex = 0; StateIndex < UE_ARRAY_COUNT(States); ++StateIndex)
+		{
+			const double StartTime{ FPlatformTime::Seconds() };
+			for (AItem* Item : Items)
+			{
+				Item->SetItemState(States[StateIndex]);
+			}
+			Transitions[StateIndex]->Add((FPlatformTime::Seconds() - StartTime) / Items.Num());
+		}
+	}
+
+	Report.Finish(FString::Printf(TEXT("Item state benchmark, %d items, %d rounds"), Items.Num(), Rounds));
+}
+
+void AShooterGameModeBase::ShooterBenchmarkShotBandwidth()
+{
+	FShooterBenchmarkReport& Report = BeginBenchmarkReport(TEXT("ShotBandwidth"));
+	const AShooterCharacter* CharacterDefaults = GetStressCharacterDefaults();
+	if (CharacterDefaults == nullptr)
+	{
+		Report.AddError(TEXT("Needs a shooter character class"));
+		return;
+	}
+
+	// A shot a few thousand units from the origin, the trace start's bits grow with its magnitude
+	FShotRequest Shot;
+	Shot.TraceStart = FVector(4000.f, -2500.f, 300.f);
+	Shot.Direction = FVector(0.6f, 0.8f, 0.f);
+	Shot.Seed = 12345;
+	Shot.Spread = FShotRequest::QuantizeSpread(1.5f);
+	Shot.Sequence = 100;
+	Shot.ClientTime = 123.456f;
+
+	FNetBitWriter Writer(nullptr, 1024 * 8);
+	bool bSuccess = true;
+	Shot.NetSerialize(Writer, nullptr, bSuccess);
+	const double ShotBytes{ Writer.GetNumBits() / 8.0 };
+
+	// The array count and the parameter's send bit, not the bunch headers
+	constexpr double RPCBytes{ 17 / 8.0 };
+
+	const double ShotsPerSecond{ 1.0 / CharacterDefaults->GetAutoFirePeriod() };
+	const double HeldRPCsPerSecond{ FMath::Min(ShotsPerSecond, (double)CharacterDefaults->NetUpdateFrequency) };
+	const double TapsPerSecond{ 3.0 };
+
+	Report.AddNote(FString::Printf(TEXT("Tapped, %.0f shots/s      %.1f B/s"),
+		TapsPerSecond, TapsPerSecond * (ShotBytes + RPCBytes)));
+	Report.AddNote(FString::Printf(TEXT("Held, %.0f shots/s, %.0f RPCs/s  %.1f B/s"),
+		ShotsPerSecond, HeldRPCsPerSecond, ShotsPerSecond * ShotBytes + HeldRPCsPerSecond * RPCBytes));
+	Report.AddNote(TEXT("Shotgun, same as above, pellets are regenerated from the seed"));
+	Report.Finish(FString::Printf(TEXT("Shot bandwidth, %.1f bytes a shot, %.1f bytes per RPC"), ShotBytes, RPCBytes));
+}
+
+void AShooterGameModeBase::ShooterBenchmarkCombatSequences(int32 NumCharacters, int32 NumItems, int32 Frames)
+{
+	FShooterBenchmarkReport& Report = BeginBenchmarkReport(TEXT("CombatSequences"));
+	UShooterBenchmarkSubsystem* BenchmarkSubsystem = GetWorld()->GetSubsystem<UShooterBenchmarkSubsystem>();
+	const AShooterCharacter* CharacterDefaults = GetStressCharacterDefaults();
+	if (BenchmarkSubsystem == nullptr || CharacterDefaults == nullptr || StressWeaponClass == nullptr ||
+		StressItemClass == nullptr || NumCharacters <= 0 || Frames <= 0)
+	{
+		Report.AddError(TEXT("Needs a shooter character class, StressWeaponClass and StressItemClass"));
+		return;
+	}
+	if (BenchmarkSubsystem->IsRecording())
+	{
+		Report.AddError(TEXT("A frame benchmark is already recording"));
+		return;
+	}
+
+	const FVector Origin{ ShooterBenchmark::GetSpawnOrigin(GetWorld()) };
+	const int32 FirstActor{ StressActors.Num() };
+	SpawnStressGrid(StressItemClass, NumItems, Origin + FVector(0.f, 0.f, -50.f));
+	const int32 FirstCharacter{ StressActors.Num() };
+	SpawnStressGrid(CharacterDefaults->GetClass(), NumCharacters, Origin);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	// What the script works on, the actors may be destroyed by anyone while the frames run
+	struct FCombatSequenceActors
+	{
+		TArray<TWeakObjectPtr<AShooterCharacter>> Characters;
+		TArray<TWeakObjectPtr<AWeapon>> SpareWeapons;
+		TArray<TWeakObjectPtr<AActor>> Spawned;
+	};
+	TSharedRef<FCombatSequenceActors> Actors = MakeShared<FCombatSequenceActors>();
+
+	for (int32 Index = FirstCharacter; Index < StressActors.Num(); ++Index)
+	{
+		AShooterCharacter* Character = Cast<AShooterCharacter>(StressActors[Index]);
+		if (Character == nullptr) continue;
+
+		// Locally controlled, so the character traces for items as a player's would
+		AAIController* Controller = GetWorld()->SpawnActor<AAIController>(SpawnParams);
+		AWeapon* Weapon = GetWorld()->SpawnActor<AWeapon>(StressWeaponClass, Character->GetActorLocation(), FRotator::ZeroRotator, SpawnParams);
+		AWeapon* SpareWeapon = GetWorld()->SpawnActor<AWeapon>(StressWeaponClass, Character->GetActorLocation(), FRotator::ZeroRotator, SpawnParams);
+		if (Controller == nullptr || Weapon == nullptr || SpareWeapon == nullptr)
+		{
+			Report.AddError(TEXT("Could not spawn its actors"));
+			continue;
+		}
+
+		Controller->Possess(Character);
+		Character->EquipWeapon(Weapon);
+
+		Actors->Characters.Add(Character);
+		Actors->SpareWeapons.Add(SpareWeapon);
+		Actors->Spawned.Add(Controller);
+		Actors->Spawned.Add(Weapon);
+		Actors->Spawned.Add(SpareWeapon);
+	}
+	for (int32 Index = FirstActor; Index < StressActors.Num(); ++Index)
+	{
+		Actors->Spawned.Add(StressActors[Index]);
+	}
+	StressActors.SetNum(FirstActor);
+
+	// Every character runs one step of the sequence every StepFrames frames, staggered so the
+	// steps spread over the frames, and strafes back and forth across the items meanwhile
+	constexpr int32 StepFrames{ 6 };
+	auto OnFrame = [Actors](int32 Frame)
+	{
+		for (int32 Index = 0; Index < Actors->Characters.Num(); ++Index)
+		{
+			AShooterCharacter* Character = Actors->Characters[Index].Get();
+			AWeapon* Weapon = Character ? Character->GetEquippedWeapon() : nullptr;
+			if (Weapon == nullptr) continue;
+
+			Character->AddActorWorldOffset(FVector(0.f, Frame % 240 < 120 ? 5.f : -5.f, 0.f));
+			if ((Frame + Index) % StepFrames != 0) continue;
+
+			switch ((Frame + Index) / StepFrames % 5)
+			{
+			case 0:
+				// Fire, without waiting for the auto fire timer
+				Weapon->SetAmmo(Weapon->GetMagazineCapacity());
+				Character->FireWeapon();
+				Character->GetWorldTimerManager().ClearTimer(Character->AutoFireTimer);
+				Character->SetCombatState(ECombatState::ECS_Unoccupied);
+				break;
+			case 1:
+				// Reload an empty magazine, the montage's finish notify done right away
+				Weapon->SetAmmo(0);
+				Character->SetCarriedAmmo(Weapon->GetAmmoType(), Weapon->GetMagazineCapacity());
+				Character->ReloadWeapon();
+				Character->ReloadMagazine();
+				break;
+			case 2:
+				Character->SetCrouching(!Character->GetCrouching());
+				break;
+			case 3:
+				// Drop, then pick the same weapon up again
+				Character->DropWeapon();
+				Character->EquipWeapon(Weapon);
+				break;
+			default:
+				if (AWeapon* SpareWeapon = Actors->SpareWeapons[Index].Get())
+				{
+					Character->SwapWeapon(SpareWeapon);
+					Actors->SpareWeapons[Index] = Weapon;
+				}
+				break;
+			}
+		}
+	};
+
+	TSharedRef<FShooterBenchmarkReport> ReportRef = LastBenchmarkReport.ToSharedRef();
+	auto OnFinished = [Actors, ReportRef, NumCharacters, NumItems, Frames]()
+	{
+		ReportRef->Finish(FString::Printf(TEXT("Combat sequence benchmark, %d characters, %d items, %d frames (per frame)"),
+			NumCharacters, NumItems, Frames));
+
+		for (const TWeakObjectPtr<AActor>& Actor : Actors->Spawned)
+		{
+			if (Actor.IsValid())
+			{
+				Actor->Destroy();
+			}
+		}
+	};
+
+	BenchmarkSubsystem->StartRecording(ReportRef, Frames, MoveTemp(OnFrame), MoveTemp(OnFinished));
+	UE_LOG(LogShooter, Log, TEXT("Combat sequence benchmark, recording %d frames"), Frames);
+}
+
+void AShooterGameModeBase::ShooterBenchmarkHitscan(int32 Shots, int32 Pellets)
+{
+	FShooterBenchmarkReport& Report = BeginBenchmarkReport(TEXT("Hitscan"));
+	if (Shots <= 0 || Pellets <= 0)
+	{
+		Report.AddError(TEXT("Needs at least one shot and one pellet"));
+		return;
+	}
+
+	const FVector Origin{ ShooterBenchmark::GetSpawnOrigin(GetWorld()) };
+	FShooterBenchmarkSamples& Rifle = Report.AddCase(TEXT("Rifle, one line trace"), Shots);
+	FShooterBenchmarkSamples& Sequential = Report.AddCase(TEXT("Sequential line trace per pellet"), Shots);
+	FShooterBenchmarkSamples& Batched = Report.AddCase(TEXT("Pellets queued as one async batch"), Shots);
+
+	for (int32 Shot = 0; Shot < Shots; ++Shot)
+	{
+		// All the way around, slightly down so some pellets reach the ground
+		const FVector Direction{ FRotator(-5.f, 360.f * Shot / Shots, 0.f).Vector() };
+
+		FHitscanBatch RifleShot;
+		RifleShot.Start = Origin;
+		RifleShot.Ends.Add(Origin + Direction * 50'000.f);
+		{
+			FShooterBenchmarkScope Scope(Rifle);
+			RifleShot.TraceSync(GetWorld());
+		}
+
+		TSharedRef<FHitscanBatch> Batch = MakeShared<FHitscanBatch>();
+		Batch->Start = Origin;
+		Batch->AddConeRays(Direction, 50'000.f, FMath::DegreesToRadians(5.f), Pellets, Shot);
+		{
+			FShooterBenchmarkScope Scope(Sequential);
+			Batch->TraceSync(GetWorld());
+		}
+
+		// What the shot costs the game thread, the traces run on the async workers until next frame
+		{
+			FShooterBenchmarkScope Scope(Batched);
+			FHitscanBatch::TraceAsync(GetWorld(), Batch, FOnHitscanBatchResolved());
+		}
+	}
+
+	Report.Finish(FString::Printf(TEXT("Hitscan benchmark, %d shots of %d pellets (per shot)"), Shots, Pellets));
+}
+
+void AShooterGameModeBase::ShooterBenchmarkItemProximity(int32 Queries)
+{
+	FShooterBenchmarkReport& Report = BeginBenchmarkReport(TEXT("ItemProximity"));
+	UItemProximitySubsystem* ProximitySubsystem = GetWorld()->GetSubsystem<UItemProximitySubsystem>();
+	if (ProximitySubsystem == nullptr || StressItemClass == nullptr || Queries <= 0)
+	{
+		Report.AddError(TEXT("Needs StressItemClass"));
+		return;
+	}
+
+	const FVector Origin{ ShooterBenchmark::GetSpawnOrigin(GetWorld()) };
+	for (const int32 NumItems : { 1'000, 10'000, 50'000 })
+	{
+		const int32 FirstItem{ StressActors.Num() };
+		SpawnStressGrid(StressItemClass, NumItems, Origin);
+
+		TArray<AItem*> Items;
+		Items.Reserve(StressActors.Num() - FirstItem);
+		for (int32 Index = FirstItem; Index < StressActors.Num(); ++Index)
+		{
+			if (AItem* Item = Cast<AItem>(StressActors[Index]))
+			{
+				Items.Add(Item);
+			}
+		}
+		const int32 NumItemsInGrid{ ProximitySubsystem->GetNumItems() };
+
+		// A character's radius, walking diagonally across the grid
+		constexpr float Radius{ 50.f };
+		const float HalfExtent{ FMath::Sqrt((float)NumItems) * StressSpawnSpacing * 0.5f };
+		const FVector From{ Origin + FVector(-HalfExtent, -HalfExtent, 0.f) };
+		const FVector To{ Origin + FVector(HalfExtent, HalfExtent, 0.f) };
+
+		FShooterBenchmarkSamples& Grid = Report.AddCase(FString::Printf(TEXT("Grid query + query id, %d items"), NumItems), Queries);
+		FShooterBenchmarkSamples& Linear = Report.AddCase(FString::Printf(TEXT("Scan every item + Contains, %d items"), NumItems), Queries);
+		TArray<AItem*> NearbyItems;
+		TArray<AItem*> PreviousNearbyItems;
+		int32 LeftRange{ 0 };
+
+		for (int32 Query = 0; Query < Queries; ++Query)
+		{
+			const FVector Location{ FMath::Lerp(From, To, (float)Query / Queries) };
+
+			{
+				FShooterBenchmarkScope Scope(Linear);
+				Swap(NearbyItems, PreviousNearbyItems);
+				NearbyItems.Reset();
+				for (AItem* Item : Items)
+				{
+					const float Range{ Radius + Item->GetPickupRadius() };
+					if (FVector::DistSquared(Location, Item->GetActorLocation()) <= Range * Range)
+					{
+						NearbyItems.Add(Item);
+					}
+				}
+				for (AItem* Item : PreviousNearbyItems)
+				{
+					LeftRange += NearbyItems.Contains(Item) ? 0 : 1;
+				}
+			}
+
+			{
+				FShooterBenchmarkScope Scope(Grid);
+				Swap(NearbyItems, PreviousNearbyItems);
+				const uint32 QueryId{ ProximitySubsystem->QueryItems(Location, Radius, NearbyItems) };
+				for (AItem* Item : PreviousNearbyItems)
+				{
+					LeftRange += UItemProximitySubsystem::WasFoundByQuery(Item, QueryId) ? 0 : 1;
+				}
+			}
+		}
+
+		Report.AddNote(FString::Printf(TEXT("%d items: %d in the grid, items left the query range %d times"),
+			NumItems, NumItemsInGrid, LeftRange));
+
+		// The next size starts from an empty grid
+		for (AItem* Item : Items)
+		{
+			Item->Destroy();
+		}
+		StressActors.SetNum(FirstItem);
+	}
+
+	Report.Finish(FString::Printf(TEXT("Item proximity benchmark, %d queries per size"), Queries));
+}
+
+void AShooterGameModeBase::ShooterBenchmarkFirstShot(int32 Characters, float Tolerance)
+{
+	FShooterBenchmarkReport& Report = BeginBenchmarkReport(TEXT("FirstShot"));
+	const AShooterCharacter* CharacterDefaults = GetStressCharacterDefaults();
+	if (CharacterDefaults == nullptr || StressWeaponClass == nullptr || Characters <= 0)
+	{
+		Report.AddError(TEXT("Needs a shooter character class and StressWeaponClass"));
+		return;
+	}
+
+	constexpr int32 ShotsPerCharacter{ 10 };
+	FShooterBenchmarkSamples& ColdShot = Report.AddCase(TEXT("FireWeapon, 1st call, 1st character"), 1);
+	FShooterBenchmarkSamples& FirstShot = Report.AddCase(TEXT("FireWeapon, 1st call"), Characters);
+	FShooterBenchmarkSamples& TenthShot = Report.AddCase(TEXT("FireWeapon, 10th call"), Characters);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (int32 Index = 0; Index < Characters; ++Index)
+	{
+		AShooterCharacter* Character = GetWorld()->SpawnActor<AShooterCharacter>(
+			CharacterDefaults->GetClass(), FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+		AWeapon* Weapon = GetWorld()->SpawnActor<AWeapon>(StressWeaponClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+		if (Character == nullptr || Weapon == nullptr)
+		{
+			Report.AddError(TEXT("Could not spawn its actors"));
+			return;
+		}
+
+		// Equipping warms the weapon's assets, as it does in game
+		Character->EquipWeapon(Weapon);
+
+		for (int32 Shot = 1; Shot <= ShotsPerCharacter; ++Shot)
+		{
+			Weapon->SetAmmo(Weapon->GetMagazineCapacity());
+
+			const double StartTime{ FPlatformTime::Seconds() };
+			Character->FireWeapon();
+			const double Seconds{ FPlatformTime::Seconds() - StartTime };
+
+			if (Shot == 1)
+			{
+				FirstShot.Add(Seconds);
+				if (Index == 0)
+				{
+					ColdShot.Add(Seconds);
+				}
+			}
+			else if (Shot == ShotsPerCharacter)
+			{
+				TenthShot.Add(Seconds);
+			}
+
+			Character->GetWorldTimerManager().ClearTimer(Character->AutoFireTimer);
+			Character->SetCombatState(ECombatState::ECS_Unoccupied);
+		}
+
+		Character->Destroy();
+		Weapon->Destroy();
+	}
+
+	// What the preload is for, no first shot hitch
+	const double Budget{ TenthShot.GetMean() * Tolerance };
+	if (ColdShot.GetMean() > Budget)
+	{
+		Report.AddError(FString::Printf(TEXT("The cold first shot took %.3f us, over %.1f times the tenth (%.3f us)"),
+			ColdShot.GetMean(), Tolerance, TenthShot.GetMean()));
+	}
+	if (FirstShot.GetMean() > Budget)
+	{
+		Report.AddError(FString::Printf(TEXT("First shots took %.3f us on average, over %.1f times the tenth (%.3f us)"),
+			FirstShot.GetMean(), Tolerance, TenthShot.GetMean()));
+	}
+	Report.Finish(FString::Printf(TEXT("First shot benchmark, %d characters"), Characters));
+}
+
+void AShooterGameModeBase::ShooterBenchmarkWeaponRig(int32 Samples)
+{
+	FShooterBenchmarkReport& Report = BeginBenchmarkReport(TEXT("WeaponRig"));
+	AWeapon* Weapon = StressWeaponClass && Samples > 0 ?
+		GetWorld()->SpawnActor<AWeapon>(StressWeaponClass, FVector::ZeroVector, FRotator::ZeroRotator) :
+		nullptr;
+	if (Weapon == nullptr || Weapon->GetItemMesh() == nullptr)
+	{
+		Report.AddError(TEXT("Needs StressWeaponClass with a mesh"));
+		return;
+	}
+
+	USkeletalMeshComponent* Mesh = Weapon->GetItemMesh();
+	FWeaponRigCache Rig;
+	Rig.Build(nullptr, Weapon);
+
+	// One lookup is too short to time on its own
+	constexpr int32 LookupsPerSample{ 100 };
+	FShooterBenchmarkSamples& Cached = Report.AddCase(TEXT("Rig cache, 100 lookups"), Samples);
+	FShooterBenchmarkSamples& ByName = Report.AddCase(TEXT("By name, 100 lookups"), Samples);
+	FTransform Transform;
+	int32 BoneIndexSum{ 0 };
+
+	for (int32 Sample = 0; Sample < Samples; ++Sample)
+	{
+		{
+			FShooterBenchmarkScope Scope(Cached);
+			for (int32 Lookup = 0; Lookup < LookupsPerSample; ++Lookup)
+			{
+				Rig.GetBarrelTransform(Transform);
+				BoneIndexSum += Rig.ClipBoneIndex;
+			}
+		}
+
+		{
+			FShooterBenchmarkScope Scope(ByName);
+			for (int32 Lookup = 0; Lookup < LookupsPerSample; ++Lookup)
+			{
+				if (const USkeletalMeshSocket* BarrelSocket = Mesh->GetSocketByName(FWeaponRigCache::BarrelSocketName))
+				{
+					Transform = BarrelSocket->GetSocketTransform(Mesh);
+				}
+				BoneIndexSum += Mesh->GetBoneIndex(Weapon->GetClipBoneName());
+			}
+		}
+	}
+
+	// The sum keeps the lookups from being optimized out
+	Report.AddNote(FString::Printf(TEXT("Bone index sum %d"), BoneIndexSum));
+	Report.Finish(FString::Printf(TEXT("Weapon rig benchmark, %d samples"), Samples));
+
+	Weapon->Destroy();
+}
+
+void AShooterGameModeBase::ShooterBenchmarkLagCompensation(int32 NumCharacters, int32 Rounds, float ShotBudgetMicroseconds)
+{
+	FShooterBenchmarkReport& Report = BeginBenchmarkReport(TEXT("LagCompensation"));
+	ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>();
+	const AShooterCharacter* CharacterDefaults = GetStressCharacterDefaults();
+	if (LagCompensation == nullptr || CharacterDefaults == nullptr || NumCharacters < 2 || Rounds <= 0)
+	{
+		Report.AddError(TEXT("Needs a shooter character class and two characters"));
+		return;
+	}
+
+	const int32 FirstCharacter{ StressActors.Num() };
+	SpawnStressGrid(CharacterDefaults->GetClass(), NumCharacters, ShooterBenchmark::GetSpawnOrigin(GetWorld()));
+
+	// Characters only register on a server, standalone included here
+	TArray<AShooterCharacter*> Characters;
+	for (int32 Index = FirstCharacter; Index < StressActors.Num(); ++Index)
+	{
+		if (AShooterCharacter* Character = Cast<AShooterCharacter>(StressActors[Index]))
+		{
+			LagCompensation->RegisterCharacter(Character);
+			Characters.Add(Character);
+		}
+	}
+
+	// A full history, one frame at 60 Hz, the characters strafing
+	const float Now{ GetWorld()->GetTimeSeconds() };
+	constexpr float FrameTime{ 1.f / 60.f };
+	FShooterBenchmarkSamples& Record = Report.AddCase(TEXT("Record frame"), FLagCompensationHistory::MaxFrames);
+	for (int32 Frame = FLagCompensationHistory::MaxFrames - 1; Frame >= 0; --Frame)
+	{
+		for (AShooterCharacter* Character : Characters)
+		{
+			Character->AddActorWorldOffset(FVector(0.f, 5.f, 0.f));
+		}
+
+		FShooterBenchmarkScope Scope(Record);
+		LagCompensation->RecordCharacters(Now - Frame * FrameTime);
+	}
+
+	FShooterBenchmarkSamples& Shot = Report.AddCase(TEXT("Rewind + trace, one shot"), Rounds * Characters.Num());
+	int32 Hits{ 0 };
+	for (int32 Round = 0; Round < Rounds; ++Round)
+	{
+		for (int32 Index = 0; Index < Characters.Num(); ++Index)
+		{
+			const AShooterCharacter* Shooter = Characters[Index];
+			const AShooterCharacter* Target = Characters[(Index + 1) % Characters.Num()];
+			const FVector Start{ Shooter->GetActorLocation() };
+			const FVector End{ Start + (Target->GetActorLocation() - Start).GetSafeNormal() * 50'000.f };
+
+			FLagCompensatedHit Hit;
+			FShooterBenchmarkScope Scope(Shot);
+			Hits += LagCompensation->TraceCharacters(Start, End, Now - 0.1f, Shooter, Hit) ? 1 : 0;
+		}
+	}
+
+	if (Shot.GetPercentile(0.99) > ShotBudgetMicroseconds)
+	{
+		Report.AddError(FString::Printf(TEXT("Shot p99 %.3f us is over the %.3f us budget"), Shot.GetPercentile(0.99), ShotBudgetMicroseconds));
+	}
+	Report.Finish(FString::Printf(TEXT("Lag compensation benchmark, %d characters, %d shots, %d hits"),
+		LagCompensation->GetNumCharacters(), Shot.Num(), Hits));
+
+	for (AShooterCharacter* Character : Characters)
+	{
+		StressActors.Remove(Character);
+		Character->Destroy();
+	}
+}
+
+FShooterBenchmarkReport& AShooterGameModeBase::BeginBenchmarkReport(const FString& Name)
+{
+	LastBenchmarkReport = MakeShared<FShooterBenchmarkReport>(Name);
+	return *LastBenchmarkReport;
+}
+
+const AShooterCharacter* AShooterGameModeBase::GetStressCharacterDefaults() const
+{
+	UClass* CharacterClass = StressCharacterClass ? StressCharacterClass.Get() : DefaultPawnClass.Get();
+	if (CharacterClass == nullptr || !CharacterClass->IsChildOf<AShooterCharacter>()) return nullptr;
+
+	return GetDefault<AShooterCharacter>(CharacterClass);
+}
+
+void AShooterGameModeBase::SpawnStressGrid(UClass* Class, int32 Count, const FVector& Origin)
+{
+	const int32 GridSize{ FMath::CeilToInt(FMath::Sqrt((float)Count)) };
+	const float HalfExtent{ (GridSize - 1) * StressSpawnSpacing * 0.5f };
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const FVector Location{ Origin + FVector(
+			(Index % GridSize) * StressSpawnSpacing - HalfExtent,
+			(Index / GridSize) * StressSpawnSpacing - HalfExtent,
+			0.f) };
+
+		if (AActor* Actor = GetWorld()->SpawnActor<AActor>(Class, Location, FRotator::ZeroRotator, SpawnParams))
+		{
+			StressActors.Add(Actor);
+		}
+	}
+}
+#pragma endregion
@@ -6,6 +6,11 @@
 #include "GameFramework/GameModeBase.h"
 #include "ShooterGameModeBase.generated.h"
 
+class AItem;
+class AShooterCharacter;
+class AWeapon;
+struct FShooterBenchmarkReport;
+
 /**
  * 
  */
@@ -13,5 +18,119 @@ UCLASS()
 class SHOOTER_API AShooterGameModeBase : public AGameModeBase
 {
 	GENERATED_BODY()
-	
+
+public:
+	AShooterGameModeBase();
+
+#pragma region Stress
+	/**
+	 * Spawns NumCharacters characters and NumItems items in a grid around the first player start.
+	 * Run headless with -nullrhi -csvprofile to capture the Shooter CSV category per frame.
+	 */
+	UFUNCTION(Exec)
+	void ShooterSpawnStressActors(int32 NumCharacters, int32 NumItems);
+
+	/** Destroys every actor spawned by ShooterSpawnStressActors */
+	UFUNCTION(Exec)
+	void ShooterClearStressActors();
+
+	/**
+	 * Spawns NumItems stress items and flips them Idle -> Pickup -> Falling -> Idle Rounds times,
+	 * logging the average cost of each transition. The items stay, clear them with ShooterClearStressActors.
+	 */
+	UFUNCTION(Exec)
+	void ShooterBenchmarkItemStates(int32 NumItems = 10000, int32 Rounds = 5);
+
+	/**
+	 * Logs the size of one serialized FShotRequest and the client -> server payload it adds up to
+	 * for tapped and held fire at the stress character's fire period and net update frequency.
+	 */
+	UFUNCTION(Exec)
+	void ShooterBenchmarkShotBandwidth();
+
+	/**
+	 * Spawns NumCharacters AI controlled stress characters with two StressWeaponClass weapons each and
+	 * NumItems stress items, then records the next Frames frames while the characters strafe through the
+	 * items and run the scripted combat sequence (fire, reload, crouch, drop, swap). Logs and writes the
+	 * per-frame mean and p99 of AShooterCharacter::Tick, FireWeapon, TraceForItems and item state
+	 * transitions once the last frame is done, then destroys what it spawned.
+	 */
+	UFUNCTION(Exec)
+	void ShooterBenchmarkCombatSequences(int32 NumCharacters = 16, int32 NumItems = 1000, int32 Frames = 600);
+
+	/**
+	 * Fires Shots pellet cones of Pellets rays around the first player start and times, per shot on the
+	 * game thread, a rifle's single line trace, the pellets as sequential line traces and the pellets
+	 * submitted as one async FHitscanBatch. Spawn stress actors first for something to hit.
+	 */
+	UFUNCTION(Exec)
+	void ShooterBenchmarkHitscan(int32 Shots = 500, int32 Pellets = 12);
+
+	/**
+	 * For 1k, 10k and 50k stress items: spawns them, walks a query point across them Queries times and
+	 * destroys them again. Times UItemProximitySubsystem's grid query with the query-id range check
+	 * against a scan of every item with a Contains range check, logging mean and p99 per query and size.
+	 */
+	UFUNCTION(Exec)
+	void ShooterBenchmarkItemProximity(int32 Queries = 1000);
+
+	/**
+	 * Spawns Characters fresh stress characters, each with a new StressWeaponClass weapon, and fires
+	 * ten shots with each, logging the first and the tenth FireWeapon call. The first character pays
+	 * for whatever the combat preload missed; in a fresh world (the automation test) nothing has warmed
+	 * its assets before. Fails if that cold first shot, or the first shots on average, cost more than
+	 * Tolerance times the tenth.
+	 */
+	UFUNCTION(Exec)
+	void ShooterBenchmarkFirstShot(int32 Characters = 20, float Tolerance = 2.f);
+
+	/**
+	 * Spawns a StressWeaponClass weapon and times Samples batches of 100 barrel transform and clip bone
+	 * lookups, through FWeaponRigCache and by name (GetSocketByName / GetBoneIndex), logging mean and p99.
+	 */
+	UFUNCTION(Exec)
+	void ShooterBenchmarkWeaponRig(int32 Samples = 1000);
+
+	/**
+	 * Spawns NumCharacters stress characters, fills their lag compensation history and has each of them
+	 * shoot at the next one Rounds times, rewound 100 ms. Logs mean and p99 of recording a frame and of
+	 * one shot's rewind + trace, and an error if the shot's p99 is over ShotBudgetMicroseconds.
+	 */
+	UFUNCTION(Exec)
+	void ShooterBenchmarkLagCompensation(int32 NumCharacters = 64, int32 Rounds = 20, float ShotBudgetMicroseconds = 50.f);
+
+	/** Results of the benchmark exec that ran last, also written to Saved/Benchmarks */
+	FORCEINLINE TSharedPtr<const FShooterBenchmarkReport> GetLastBenchmarkReport() const { return LastBenchmarkReport; }
+
+private:
+	/** Character class used by ShooterSpawnStressActors, DefaultPawnClass if not set */
+	UPROPERTY(EditDefaultsOnly, Category = Stress, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<AShooterCharacter> StressCharacterClass;
+
+	/** Item class used by ShooterSpawnStressActors */
+	UPROPERTY(EditDefaultsOnly, Category = Stress, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<AItem> StressItemClass;
+
+	/** Weapons the benchmarks equip, fire and swap */
+	UPROPERTY(EditDefaultsOnly, Category = Stress, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<AWeapon> StressWeaponClass;
+
+	/** Distance between spawned stress actors */
+	UPROPERTY(EditDefaultsOnly, Category = Stress, meta = (AllowPrivateAccess = "true"))
+	float StressSpawnSpacing;
+
+	UPROPERTY()
+	TArray<AActor*> StressActors;
+
+	TSharedPtr<FShooterBenchmarkReport> LastBenchmarkReport;
+
+	/** Replaces LastBenchmarkReport, every benchmark exec starts with it */
+	FShooterBenchmarkReport& BeginBenchmarkReport(const FString& Name);
+
+	/** Default object of StressCharacterClass, or of DefaultPawnClass if it is a shooter character */
+	const AShooterCharacter* GetStressCharacterDefaults() const;
+
+	/** Spawns Count actors of Class in a square grid centered on Origin */
+	void SpawnStressGrid(UClass* Class, int32 Count, const FVector& Origin);
+#pragma endregion
 };
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterHUDOverlay.h"
+#include "ShooterCharacter.h"
+#include "Weapon.h"
+#include "Components/TextBlock.h"
+#include "Components/InvalidationBox.h"
+#include "Blueprint/WidgetTree.h"
+
+static TAutoConsoleVariable<bool> CVarShooterHUDInvalidation(
+	TEXT("Shooter.HUDInvalidation"),
+	true,
+	TEXT("Wrap the HUD overlay in an invalidation box when it is created. Off is the baseline of\n")
+	TEXT("Scripts/HUDBenchmark.sh."));
+
+void UShooterHUDOverlay::SetCharacter(AShooterCharacter* Character)
+{
+	if (BoundCharacter.Get() == Character) return;
+
+	if (AShooterCharacter* OldCharacter = BoundCharacter.Get())
+	{
+		OldCharacter->OnEquippedWeaponChanged.Remove(EquippedWeaponChangedHandle);
+		OldCharacter->OnCarriedAmmoChanged.Remove(CarriedAmmoChangedHandle);
+	}
+	EquippedWeaponChangedHandle.Reset();
+	CarriedAmmoChangedHandle.Reset();
+
+	BoundCharacter = Character;
+	if (Character)
+	{
+		EquippedWeaponChangedHandle = Character->OnEquippedWeaponChanged.AddUObject(this, &UShooterHUDOverlay::OnEquippedWeaponChanged);
+		CarriedAmmoChangedHandle = Character->OnCarriedAmmoChanged.AddUObject(this, &UShooterHUDOverlay::OnCarriedAmmoChanged);
+	}
+	SetWeapon(Character ? Character->GetEquippedWeapon() : nullptr);
+}
+
+void UShooterHUDOverlay::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
+
+	// Before the Slate widgets are built, so the box is part of them from the start
+	if (!CVarShooterHUDInvalidation.GetValueOnGameThread() || WidgetTree == nullptr) return;
+
+	UWidget* Root = WidgetTree->RootWidget;
+	if (Root == nullptr || Root->IsA<UInvalidationBox>()) return;
+
+	UInvalidationBox* InvalidationBox = WidgetTree->ConstructWidget<UInvalidationBox>(
+		UInvalidationBox::StaticClass(), TEXT("OverlayInvalidationBox"));
+	InvalidationBox->SetContent(Root);
+	WidgetTree->RootWidget = InvalidationBox;
+}
+
+void UShooterHUDOverlay::NativeDestruct()
+{
+	SetCharacter(nullptr);
+
+	Super::NativeDestruct();
+}
+
+void UShooterHUDOverlay::SetWeapon(AWeapon* Weapon)
+{
+	if (AWeapon* OldWeapon = BoundWeapon.Get())
+	{
+		OldWeapon->OnAmmoChanged.Remove(WeaponAmmoChangedHandle);
+	}
+	WeaponAmmoChangedHandle.Reset();
+
+	BoundWeapon = Weapon;
+	if (Weapon)
+	{
+		WeaponAmmoChangedHandle = Weapon->OnAmmoChanged.AddUObject(this, &UShooterHUDOverlay::OnWeaponAmmoChanged);
+	}
+
+	// Weapon changes are rare, refresh everything
+	if (WeaponNameText)
+	{
+		WeaponNameText->SetText(Weapon ? FText::FromString(Weapon->GetItemName()) : FText::GetEmpty());
+	}
+	SetNumberText(AmmoText, Weapon ? Weapon->GetAmmo() : 0, ShownAmmo);
+
+	const AShooterCharacter* Character = BoundCharacter.Get();
+	SetNumberText(CarriedAmmoText, Character && Weapon ? Character->GetCarriedAmmo(Weapon->GetAmmoType()) : 0, ShownCarriedAmmo);
+}
+
+void UShooterHUDOverlay::OnEquippedWeaponChanged(AWeapon* Weapon)
+{
+	SetWeapon(Weapon);
+}
+
+void UShooterHUDOverlay::OnWeaponAmmoChanged(AWeapon* Weapon)
+{
+	if (Weapon != BoundWeapon.Get()) return;
+
+	SetNumberText(AmmoText, Weapon->GetAmmo(), ShownAmmo);
+}
+
+void UShooterHUDOverlay::OnCarriedAmmoChanged(EMyAmmoType AmmoType, int32 CarriedAmmo)
+{
+	const AWeapon* Weapon = BoundWeapon.Get();
+	if (Weapon == nullptr || Weapon->GetAmmoType() != AmmoType) return;
+
+	SetNumberText(CarriedAmmoText, CarriedAmmo, ShownCarriedAmmo);
+}
+
+void UShooterHUDOverlay::SetNumberText(UTextBlock* TextBlock, int32 Value, int32& LastValue)
+{
+	if (TextBlock == nullptr || Value == LastValue) return;
+
+	LastValue = Value;
+	TextBlock->SetText(FText::AsNumber(Value));
+}
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "MyAmmoType.h"
+#include "ShooterHUDOverlay.generated.h"
+
+class AShooterCharacter;
+class AWeapon;
+class UTextBlock;
+
+/**
+ * HUD overlay fed by the character and weapon delegates instead of property bindings.
+ * Widgets are only touched when the value they show changes, and the whole overlay sits in an
+ * invalidation box so Slate reuses its cached draw until one of them does.
+ */
+UCLASS()
+class SHOOTER_API UShooterHUDOverlay : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/** Binds to Character and its equipped weapon, null unbinds */
+	void SetCharacter(AShooterCharacter* Character);
+
+protected:
+	/** Wraps the root widget of the tree in an invalidation box */
+	virtual void NativeOnInitialized() override;
+	virtual void NativeDestruct() override;
+
+private:
+	void SetWeapon(AWeapon* Weapon);
+
+	void OnEquippedWeaponChanged(AWeapon* Weapon);
+	void OnWeaponAmmoChanged(AWeapon* Weapon);
+	void OnCarriedAmmoChanged(EMyAmmoType AmmoType, int32 CarriedAmmo);
+
+	/** Sets the text of TextBlock to Value if it differs from LastValue */
+	static void SetNumberText(UTextBlock* TextBlock, int32 Value, int32& LastValue);
+
+#pragma region Widgets
+	/** Ammo in the equipped weapon's magazine */
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* AmmoText;
+
+	/** Ammo carried for the equipped weapon's ammo type */
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* CarriedAmmoText;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* WeaponNameText;
+#pragma endregion
+
+	TWeakObjectPtr<AShooterCharacter> BoundCharacter;
+	TWeakObjectPtr<AWeapon> BoundWeapon;
+
+	FDelegateHandle EquippedWeaponChangedHandle;
+	FDelegateHandle CarriedAmmoChangedHandle;
+	FDelegateHandle WeaponAmmoChangedHandle;
+
+	// Last values shown, INDEX_NONE before the first update
+	int32 ShownAmmo = INDEX_NONE;
+	int32 ShownCarriedAmmo = INDEX_NONE;
+};
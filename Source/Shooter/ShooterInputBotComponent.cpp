@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterInputBotComponent.h"
+#include "Shooter.h"
+#include "ShooterCharacter.h"
+#include "Weapon.h"
+#include "GameFramework/Controller.h"
+#include "Misc/CommandLine.h"
+
+UShooterInputBotComponent::UShooterInputBotComponent() :
+	MoveInterval(2.f),
+	FireInterval(1.5f),
+	FireDuration(0.6f),
+	AimInterval(5.f),
+	CrouchInterval(7.f),
+	SelectInterval(3.f),
+	ForwardInput(0.f),
+	RightInput(0.f),
+	TurnRate(0.f),
+	LookUpRate(0.f),
+	bFiring(false),
+	NextMoveTime(0.f),
+	NextFireTime(0.f),
+	FireReleaseTime(0.f),
+	NextAimTime(0.f),
+	NextCrouchTime(0.f),
+	NextSelectTime(0.f)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	// Input runs before the pawn ticks
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+bool UShooterInputBotComponent::IsRequestedOnCommandLine()
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("ShooterBot"));
+}
+
+void UShooterInputBotComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Each client of a run gets its own, reproducible script
+	int32 Seed = 0;
+	FParse::Value(FCommandLine::Get(), TEXT("ShooterBotSeed="), Seed);
+	Random.Initialize(Seed);
+
+	// Don't have every bot act on the same frame
+	const float Time = GetWorld()->GetTimeSeconds();
+	NextFireTime = Time + Random.FRandRange(0.f, FireInterval);
+	NextAimTime = Time + Random.FRandRange(0.f, AimInterval);
+	NextCrouchTime = Time + Random.FRandRange(0.f, CrouchInterval);
+	NextSelectTime = Time + Random.FRandRange(0.f, SelectInterval);
+
+	UE_LOG(LogShooter, Log, TEXT("%s: input bot running with seed %d"), *GetOwner()->GetName(), Seed);
+}
+
+void UShooterInputBotComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const AController* Controller = Cast<AController>(GetOwner());
+	AShooterCharacter* Character = Controller ? Cast<AShooterCharacter>(Controller->GetPawn()) : nullptr;
+	if (Character == nullptr) return;
+
+	const float Time = GetWorld()->GetTimeSeconds();
+
+	if (Time >= NextMoveTime)
+	{
+		ChooseMovement(Character, Time);
+	}
+	Character->MoveForward(ForwardInput);
+	Character->MoveRight(RightInput);
+	Character->TurnAtRate(TurnRate);
+	Character->LookUpAtRate(LookUpRate);
+
+	UpdateFiring(Character, Time);
+
+	if (Time >= NextAimTime)
+	{
+		Character->SwitchAim();
+		NextAimTime = Time + Random.FRandRange(0.5f, 1.5f) * AimInterval;
+	}
+
+	if (Time >= NextCrouchTime)
+	{
+		Character->CrouchButtonPressed();
+		NextCrouchTime = Time + Random.FRandRange(0.5f, 1.5f) * CrouchInterval;
+	}
+
+	if (Time >= NextSelectTime)
+	{
+		// Picks up / swaps for whatever TraceForItems found, no-op otherwise
+		Character->SelectButtonPressed();
+		Character->SelectButtonReleased();
+		NextSelectTime = Time + Random.FRandRange(0.5f, 1.5f) * SelectInterval;
+	}
+}
+
+void UShooterInputBotComponent::ChooseMovement(AShooterCharacter* Character, float Time)
+{
+	ForwardInput = Random.FRandRange(-1.f, 1.f);
+	RightInput = Random.FRandRange(-1.f, 1.f);
+	TurnRate = Random.FRandRange(-0.5f, 0.5f);
+
+	// Drift back towards the horizon so the crosshair keeps hitting characters and items
+	const float Pitch = FRotator::NormalizeAxis(Character->GetControlRotation().Pitch);
+	LookUpRate = FMath::Clamp(Pitch / 45.f, -1.f, 1.f) * 0.25f + Random.FRandRange(-0.1f, 0.1f);
+
+	NextMoveTime = Time + Random.FRandRange(0.5f, 1.5f) * MoveInterval;
+}
+
+void UShooterInputBotComponent::UpdateFiring(AShooterCharacter* Character, float Time)
+{
+	if (bFiring)
+	{
+		if (Time < FireReleaseTime) return;
+
+		Character->FireButtonReleased();
+		bFiring = false;
+		NextFireTime = Time + Random.FRandRange(0.5f, 1.5f) * FireInterval;
+
+		// Auto fire reloads an empty magazine, this covers partial ones
+		const AWeapon* Weapon = Character->GetEquippedWeapon();
+		if (Weapon && Weapon->GetAmmo() < Weapon->GetMagazineCapacity() / 2)
+		{
+			Character->ReloadButtonPressed();
+		}
+	}
+	else if (Time >= NextFireTime)
+	{
+		Character->FireButtonPressed();
+		bFiring = true;
+		FireReleaseTime = Time + FireDuration;
+	}
+}
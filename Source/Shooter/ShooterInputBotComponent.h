@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ShooterInputBotComponent.generated.h"
+
+class AShooterCharacter;
+
+/**
+ * Scripted stand-in for a player, added to the local player controller of clients started with
+ * -ShooterBot. Moves, looks around, fires, reloads, aims, crouches and picks up items through the
+ * same handlers the input bindings call, so a headless client exercises the regular gameplay paths.
+ */
+UCLASS(ClassGroup = (Shooter), meta = (BlueprintSpawnableComponent))
+class SHOOTER_API UShooterInputBotComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UShooterInputBotComponent();
+
+	/** -ShooterBot, seed the script with -ShooterBotSeed=N */
+	static bool IsRequestedOnCommandLine();
+
+	virtual void BeginPlay() override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	/** Picks a new movement direction and look rates */
+	void ChooseMovement(AShooterCharacter* Character, float Time);
+
+	void UpdateFiring(AShooterCharacter* Character, float Time);
+
+	/** Seconds a movement choice is held, on average */
+	UPROPERTY(EditAnywhere, Category = Bot)
+	float MoveInterval;
+
+	/** Seconds between bursts, and how long a burst holds the trigger */
+	UPROPERTY(EditAnywhere, Category = Bot)
+	float FireInterval;
+	UPROPERTY(EditAnywhere, Category = Bot)
+	float FireDuration;
+
+	/** Seconds between aim / crouch toggles */
+	UPROPERTY(EditAnywhere, Category = Bot)
+	float AimInterval;
+	UPROPERTY(EditAnywhere, Category = Bot)
+	float CrouchInterval;
+
+	/** Seconds between attempts to pick up the item under the crosshair */
+	UPROPERTY(EditAnywhere, Category = Bot)
+	float SelectInterval;
+
+	FRandomStream Random;
+
+	float ForwardInput;
+	float RightInput;
+	float TurnRate;
+	float LookUpRate;
+
+	bool bFiring;
+
+	float NextMoveTime;
+	float NextFireTime;
+	float FireReleaseTime;
+	float NextAimTime;
+	float NextCrouchTime;
+	float NextSelectTime;
+};
@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterNetStatsSubsystem.h"
+#include "Shooter.h"
+#include "Item.h"
+#include "EngineUtils.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+bool UShooterNetStatsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if CSV_PROFILER
+	return Super::ShouldCreateSubsystem(Outer);
+#else
+	return false;
+#endif
+}
+
+void UShooterNetStatsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(
+		this, &UShooterNetStatsSubsystem::OnPreGarbageCollect);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(
+		this, &UShooterNetStatsSubsystem::OnPostGarbageCollect);
+}
+
+void UShooterNetStatsSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+	Super::Deinitialize();
+}
+
+void UShooterNetStatsSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+#if CSV_PROFILER
+	if (!FCsvProfiler::Get()->IsCapturing()) return;
+
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (NetDriver == nullptr) return;
+
+	int32 NumConnections = 0;
+	int32 OutBytesTotal = 0;
+	int32 OutBytesMax = 0;
+	int32 InBytesTotal = 0;
+	int32 InBytesMax = 0;
+	float PingMax = 0.f;
+
+	auto SampleConnection = [&](const UNetConnection* Connection)
+	{
+		if (Connection == nullptr) return;
+
+		NumConnections++;
+		OutBytesTotal += Connection->OutBytesPerSecond;
+		OutBytesMax = FMath::Max(OutBytesMax, Connection->OutBytesPerSecond);
+		InBytesTotal += Connection->InBytesPerSecond;
+		InBytesMax = FMath::Max(InBytesMax, Connection->InBytesPerSecond);
+		PingMax = FMath::Max(PingMax, Connection->AvgLag * 1000.f);
+	};
+
+	SampleConnection(NetDriver->ServerConnection);
+	for (const UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		SampleConnection(Connection);
+	}
+
+	CSV_CUSTOM_STAT(Shooter, NetConnections, NumConnections, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Shooter, NetOutBytesPerSecTotal, OutBytesTotal, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Shooter, NetOutBytesPerSecMax, OutBytesMax, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Shooter, NetInBytesPerSecTotal, InBytesTotal, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Shooter, NetInBytesPerSecMax, InBytesMax, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Shooter, NetPingMsMax, PingMax, ECsvCustomStatOp::Set);
+
+	if (NetDriver->IsServer())
+	{
+		// Walking every item each frame would show up in the frame times it sits next to
+		const double Now{ FPlatformTime::Seconds() };
+		if (Now >= NextDormantItemsCountTime)
+		{
+			NextDormantItemsCountTime = Now + 1.0;
+			NumDormantItems = 0;
+			for (TActorIterator<AItem> It(GetWorld()); It; ++It)
+			{
+				if (It->NetDormancy >= DORM_DormantAll)
+				{
+					NumDormantItems++;
+				}
+			}
+		}
+		CSV_CUSTOM_STAT(Shooter, DormantItems, NumDormantItems, ECsvCustomStatOp::Set);
+	}
+#endif
+}
+
+TStatId UShooterNetStatsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterNetStatsSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterNetStatsSubsystem::OnPreGarbageCollect()
+{
+	GarbageCollectStartTime = FPlatformTime::Seconds();
+}
+
+void UShooterNetStatsSubsystem::OnPostGarbageCollect()
+{
+	// Summed in case an incremental purge finishes more than one collection in a frame
+	const float GarbageCollectMs = (float)((FPlatformTime::Seconds() - GarbageCollectStartTime) * 1000.0);
+	CSV_CUSTOM_STAT(Shooter, GarbageCollectMs, GarbageCollectMs, ECsvCustomStatOp::Accumulate);
+}
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterNetStatsSubsystem.generated.h"
+
+/**
+ * Adds per-connection bandwidth, ping and garbage collection time to the Shooter CSV category
+ * while a -csvprofile capture runs, next to the engine's own frame / game thread timings.
+ * On a server every client connection is sampled, on a client its server connection. A server
+ * also records how many items are net dormant.
+ */
+UCLASS()
+class SHOOTER_API UShooterNetStatsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	FDelegateHandle PreGarbageCollectHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+
+	double GarbageCollectStartTime = 0.0;
+
+	/** Items dormant at the last count, recounted about once a second */
+	int32 NumDormantItems = 0;
+	double NextDormantItemsCountTime = 0.0;
+};
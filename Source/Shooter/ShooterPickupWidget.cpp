@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterPickupWidget.h"
+#include "Item.h"
+#include "Weapon.h"
+#include "Components/TextBlock.h"
+
+void UShooterPickupWidget::SetItem(AItem* Item)
+{
+	if (ItemNameText)
+	{
+		ItemNameText->SetText(Item ? FText::FromString(Item->GetItemName()) : FText::GetEmpty());
+	}
+	if (ItemCountText)
+	{
+		ItemCountText->SetText(Item ? FText::AsNumber(Item->GetItemCount()) : FText::GetEmpty());
+	}
+	if (AmmoText)
+	{
+		const AWeapon* Weapon = Cast<AWeapon>(Item);
+		AmmoText->SetVisibility(Weapon ? ESlateVisibility::HitTestInvisible : ESlateVisibility::Collapsed);
+		if (Weapon)
+		{
+			AmmoText->SetText(FText::AsNumber(Weapon->GetAmmo()));
+		}
+	}
+
+	OnItemChanged(Item);
+}
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "ShooterPickupWidget.generated.h"
+
+class AItem;
+class UTextBlock;
+
+/**
+ * The one pickup widget of a local player, owned by AShooterPlayerController and moved over
+ * whichever item the crosshair is on. Repopulated only when the focused item changes.
+ */
+UCLASS()
+class SHOOTER_API UShooterPickupWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/** Fills the widget from Item, null clears it */
+	void SetItem(AItem* Item);
+
+protected:
+	/** For anything the native texts don't cover */
+	UFUNCTION(BlueprintImplementableEvent, Category = Pickup)
+	void OnItemChanged(AItem* Item);
+
+private:
+#pragma region Widgets
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* ItemNameText;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* ItemCountText;
+
+	/** Magazine of a weapon, collapsed for other items */
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* AmmoText;
+#pragma endregion
+};
@@ -3,8 +3,17 @@
 
 #include "ShooterPlayerController.h"
 #include "Blueprint/UserWidget.h"
+#include "ShooterHUDOverlay.h"
+#include "ShooterCharacter.h"
+#include "ShooterInputBotComponent.h"
+#include "ShooterSignificanceManager.h"
+#include "ShooterPickupWidget.h"
+#include "Item.h"
 
-AShooterPlayerController::AShooterPlayerController()
+AShooterPlayerController::AShooterPlayerController() :
+	HUDOverlay(nullptr),
+	PickupWidget(nullptr),
+	InputBot(nullptr)
 {
 
 }
@@ -13,6 +22,13 @@ void AShooterPlayerController::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Headless load-test client
+	if (IsLocalController() && UShooterInputBotComponent::IsRequestedOnCommandLine())
+	{
+		InputBot = NewObject<UShooterInputBotComponent>(this, TEXT("InputBot"));
+		InputBot->RegisterComponent();
+	}
+
 	// Check our HUDOverlayClass TSubclassOf variable
 	if (HUDOverlayClass)
 	{
@@ -21,6 +37,96 @@ void AShooterPlayerController::BeginPlay()
 		{
 			HUDOverlay->AddToViewport();
 			HUDOverlay->SetVisibility(ESlateVisibility::Visible);
+
+			if (UShooterHUDOverlay* ShooterOverlay = Cast<UShooterHUDOverlay>(HUDOverlay))
+			{
+				ShooterOverlay->SetCharacter(Cast<AShooterCharacter>(GetPawn()));
+			}
+		}
+	}
+
+	// Shared by every item, replaces a widget component per item
+	if (IsLocalController() && PickupWidgetClass)
+	{
+		PickupWidget = CreateWidget<UShooterPickupWidget>(this, PickupWidgetClass);
+		if (PickupWidget)
+		{
+			PickupWidget->AddToViewport();
+			PickupWidget->SetAlignmentInViewport(FVector2D(0.5f, 1.f));
+			PickupWidget->SetVisibility(ESlateVisibility::Collapsed);
 		}
 	}
-}
\ No newline at end of file
+}
+
+void AShooterPlayerController::SetPawn(APawn* InPawn)
+{
+	Super::SetPawn(InPawn);
+
+	if (UShooterHUDOverlay* ShooterOverlay = Cast<UShooterHUDOverlay>(HUDOverlay))
+	{
+		ShooterOverlay->SetCharacter(Cast<AShooterCharacter>(InPawn));
+	}
+}
+
+void AShooterPlayerController::PlayerTick(float DeltaTime)
+{
+	Super::PlayerTick(DeltaTime);
+
+	// Also once the item is gone, so the widget gets hidden
+	if (!FocusedItem.IsExplicitlyNull())
+	{
+		UpdatePickupWidget();
+	}
+
+	UShooterSignificanceManager* SignificanceManager = USignificanceManager::Get<UShooterSignificanceManager>(GetWorld());
+	if (SignificanceManager == nullptr) return;
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	const FTransform Viewpoint(ViewRotation, ViewLocation);
+	SignificanceManager->Update(MakeArrayView(&Viewpoint, 1));
+}
+
+void AShooterPlayerController::SetFocusedItem(AItem* Item)
+{
+	if (FocusedItem.Get() == Item || PickupWidget == nullptr) return;
+
+	FocusedItem = Item;
+	PickupWidget->SetItem(Item);
+
+	if (Item)
+	{
+		UpdatePickupWidget();
+	}
+	else
+	{
+		PickupWidget->SetVisibility(ESlateVisibility::Collapsed);
+	}
+}
+
+void AShooterPlayerController::UpdatePickupWidget()
+{
+	AItem* Item = FocusedItem.Get();
+
+	// Destroyed since it was focused
+	if (Item == nullptr)
+	{
+		SetFocusedItem(nullptr);
+		return;
+	}
+
+	// Picked up or thrown, the character keeps it focused and won't focus it again, so only hide it
+	FVector2D ScreenPosition;
+	if (Item->GetItemState() == EItemState::EIS_Pickup &&
+		ProjectWorldLocationToScreen(Item->GetPickupWidgetLocation(), ScreenPosition, true))
+	{
+		PickupWidget->SetPositionInViewport(ScreenPosition);
+		PickupWidget->SetVisibility(ESlateVisibility::HitTestInvisible);
+	}
+	else
+	{
+		PickupWidget->SetVisibility(ESlateVisibility::Collapsed);
+	}
+}
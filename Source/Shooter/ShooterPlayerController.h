@@ -17,6 +17,15 @@ class SHOOTER_API AShooterPlayerController : public APlayerController
 		public:
 	AShooterPlayerController();
 
+	/** Points the HUD overlay at the new pawn */
+	virtual void SetPawn(APawn* InPawn) override;
+
+	/** Updates character significance from this player's view */
+	virtual void PlayerTick(float DeltaTime) override;
+
+	/** Shows the pickup widget over Item, null hides it */
+	void SetFocusedItem(class AItem* Item);
+
 protected:
 
 	virtual void BeginPlay() override;
@@ -29,4 +38,21 @@ private:
 	/** Variable to hold the HUD Overlay Widget after creating it */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Widgets, meta = (AllowPrivateAccess = "true"))
 	UUserWidget* HUDOverlay;
+
+	/** Pickup widget class, one instance per local player */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Widgets, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<class UShooterPickupWidget> PickupWidgetClass;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Widgets, meta = (AllowPrivateAccess = "true"))
+	UShooterPickupWidget* PickupWidget;
+
+	/** Item the pickup widget currently shows */
+	TWeakObjectPtr<AItem> FocusedItem;
+
+	/** Projects the focused item onto the screen, hides the widget while the item can't be picked up */
+	void UpdatePickupWidget();
+
+	/** Scripted input on load-test clients, see UShooterInputBotComponent */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Bot, meta = (AllowPrivateAccess = "true"))
+	class UShooterInputBotComponent* InputBot;
 };
@@ -0,0 +1,197 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterReplicationGraph.h"
+#include "Shooter.h"
+#include "ShooterCharacter.h"
+#include "Item.h"
+#include "Weapon.h"
+#include "Engine/LevelScriptActor.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "UObject/UObjectIterator.h"
+
+UShooterReplicationGraph::UShooterReplicationGraph() :
+	GridNode(nullptr),
+	AlwaysRelevantNode(nullptr),
+	GridCellSize(10'000.f),
+	SpatialBiasX(-150'000.f),
+	SpatialBiasY(-200'000.f)
+{
+}
+
+void UShooterReplicationGraph::ResetGameWorldState()
+{
+	Super::ResetGameWorldState();
+
+	DependentWeapons.Reset();
+}
+
+void UShooterReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// Explicit policies, subclasses inherit them
+	ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), EShooterClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(APlayerController::StaticClass(), EShooterClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(AInfo::StaticClass(), EShooterClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(AShooterCharacter::StaticClass(), EShooterClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(AItem::StaticClass(), EShooterClassRepNodeMapping::Spatialize_Dormancy);
+
+	// Replication period and cull distance of every replicated class, from its CDO
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+		if (ActorCDO == nullptr || !ActorCDO->GetIsReplicated()) continue;
+
+		// Blueprint compilation leftovers
+		const FString ClassName{ Class->GetName() };
+		if (ClassName.StartsWith(TEXT("SKEL_")) || ClassName.StartsWith(TEXT("REINST_"))) continue;
+
+		const EShooterClassRepNodeMapping Policy{ GetMappingPolicy(Class) };
+		const bool bSpatialize{
+			Policy == EShooterClassRepNodeMapping::Spatialize_Static ||
+			Policy == EShooterClassRepNodeMapping::Spatialize_Dynamic ||
+			Policy == EShooterClassRepNodeMapping::Spatialize_Dormancy };
+
+		FClassReplicationInfo ClassInfo;
+		InitClassReplicationInfo(ClassInfo, Class, bSpatialize);
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+
+	EquipWeaponHandle = AShooterCharacter::NotifyEquipWeapon.AddUObject(this, &UShooterReplicationGraph::OnCharacterEquipWeapon);
+	UnEquipWeaponHandle = AShooterCharacter::NotifyUnEquipWeapon.AddUObject(this, &UShooterReplicationGraph::OnCharacterUnEquipWeapon);
+}
+
+void UShooterReplicationGraph::InitGlobalGraphNodes()
+{
+	// Characters and items
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = FVector2D(SpatialBiasX, SpatialBiasY);
+	AddGlobalGraphNode(GridNode);
+
+	// Game state, player states
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UShooterReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	// Player controller, pawn and view target of the connection
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantForConnectionNode =
+		CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(AlwaysRelevantForConnectionNode, RepGraphConnection);
+}
+
+void UShooterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EShooterClassRepNodeMapping::NotRouted:
+		break;
+	case EShooterClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case EShooterClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case EShooterClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case EShooterClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	}
+}
+
+void UShooterReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	// Destroyed while equipped, not in the grid
+	if (DependentWeapons.Remove(ActorInfo.Actor) > 0) return;
+
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EShooterClassRepNodeMapping::NotRouted:
+		break;
+	case EShooterClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case EShooterClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case EShooterClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case EShooterClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	}
+}
+
+void UShooterReplicationGraph::BeginDestroy()
+{
+	AShooterCharacter::NotifyEquipWeapon.Remove(EquipWeaponHandle);
+	AShooterCharacter::NotifyUnEquipWeapon.Remove(UnEquipWeaponHandle);
+
+	Super::BeginDestroy();
+}
+
+EShooterClassRepNodeMapping UShooterReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	if (const EShooterClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class))
+	{
+		return *Policy;
+	}
+
+	const EShooterClassRepNodeMapping Policy{ GetDefaultMappingPolicy(Class->GetDefaultObject<AActor>()) };
+	ClassRepNodePolicies.Set(Class, Policy);
+	return Policy;
+}
+
+EShooterClassRepNodeMapping UShooterReplicationGraph::GetDefaultMappingPolicy(const AActor* ActorCDO) const
+{
+	if (ActorCDO == nullptr || ActorCDO->bOnlyRelevantToOwner)
+	{
+		return EShooterClassRepNodeMapping::NotRouted;
+	}
+	if (ActorCDO->bAlwaysRelevant)
+	{
+		return EShooterClassRepNodeMapping::RelevantAllConnections;
+	}
+	return ActorCDO->IsReplicatingMovement() ?
+		EShooterClassRepNodeMapping::Spatialize_Dynamic :
+		EShooterClassRepNodeMapping::Spatialize_Static;
+}
+
+void UShooterReplicationGraph::InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool bSpatialize) const
+{
+	const AActor* ActorCDO = Class->GetDefaultObject<AActor>();
+	if (bSpatialize)
+	{
+		Info.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared);
+	}
+	Info.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->NetUpdateFrequency);
+}
+
+void UShooterReplicationGraph::OnCharacterEquipWeapon(AShooterCharacter* Character, AWeapon* Weapon)
+{
+	// The delegates are static, every world's characters broadcast them
+	if (Character == nullptr || Weapon == nullptr || Character->GetWorld() != GetWorld() || DependentWeapons.Contains(Weapon)) return;
+
+	GridNode->RemoveActor_Dormancy(FNewReplicatedActorInfo(Weapon));
+	GlobalActorReplicationInfoMap.AddDependentActor(Character, Weapon);
+	DependentWeapons.Add(Weapon);
+}
+
+void UShooterReplicationGraph::OnCharacterUnEquipWeapon(AShooterCharacter* Character, AWeapon* Weapon)
+{
+	if (Character == nullptr || Weapon == nullptr || Character->GetWorld() != GetWorld() || DependentWeapons.Remove(Weapon) == 0) return;
+
+	GlobalActorReplicationInfoMap.RemoveDependentActor(Character, Weapon);
+	GridNode->AddActor_Dormancy(FNewReplicatedActorInfo(Weapon), GlobalActorReplicationInfoMap.Get(Weapon));
+}
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "ShooterReplicationGraph.generated.h"
+
+class AShooterCharacter;
+class AWeapon;
+
+/** How actors of a class are routed to the graph nodes */
+enum class EShooterClassRepNodeMapping : uint32
+{
+	/** Not routed, replicated through another actor (equipped weapons) or not at all */
+	NotRouted,
+	/** Always relevant to every connection (game state, player states) */
+	RelevantAllConnections,
+	/** Spatialized, never moves */
+	Spatialize_Static,
+	/** Spatialized, location updated every frame (characters) */
+	Spatialize_Dynamic,
+	/** Spatialized, static while dormant, dynamic while awake (items) */
+	Spatialize_Dormancy,
+};
+
+/**
+ * Replication graph of the game: characters and items in a 2D grid so relevancy is only
+ * evaluated against nearby cells, equipped weapons replicated as dependents of their character.
+ * Enabled with ReplicationDriverClassName in DefaultEngine.ini.
+ */
+UCLASS(Transient, Config = Engine)
+class SHOOTER_API UShooterReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	UShooterReplicationGraph();
+
+	virtual void ResetGameWorldState() override;
+
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	virtual void BeginDestroy() override;
+
+private:
+	EShooterClassRepNodeMapping GetMappingPolicy(UClass* Class);
+
+	/** Default policy of a class not set explicitly, from its CDO */
+	EShooterClassRepNodeMapping GetDefaultMappingPolicy(const AActor* ActorCDO) const;
+
+	void InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool bSpatialize) const;
+
+	/** Equipped weapons leave the grid and replicate with their character */
+	void OnCharacterEquipWeapon(AShooterCharacter* Character, AWeapon* Weapon);
+	void OnCharacterUnEquipWeapon(AShooterCharacter* Character, AWeapon* Weapon);
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	TClassMap<EShooterClassRepNodeMapping> ClassRepNodePolicies;
+
+	/** Weapons currently routed through their character instead of the grid */
+	TSet<AActor*> DependentWeapons;
+
+	FDelegateHandle EquipWeaponHandle;
+	FDelegateHandle UnEquipWeaponHandle;
+
+	UPROPERTY(Config)
+	float GridCellSize;
+
+	/** Lowest world X / Y covered by the grid, actors below are clamped to the edge cells */
+	UPROPERTY(Config)
+	float SpatialBiasX;
+
+	UPROPERTY(Config)
+	float SpatialBiasY;
+};
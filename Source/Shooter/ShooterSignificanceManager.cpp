@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterSignificanceManager.h"
+#include "ShooterCharacter.h"
+#include "Components/SkeletalMeshComponent.h"
+
+const FName UShooterSignificanceManager::CharacterTag(TEXT("ShooterCharacter"));
+
+UShooterSignificanceManager::UShooterSignificanceManager() :
+	NearDistance(1500.f),
+	FarDistance(4000.f),
+	VisibilityTimeout(0.25f)
+{
+	Settings[(int32)EShooterSignificance::ESS_Full] = { 0.f, 0.f, false };
+	Settings[(int32)EShooterSignificance::ESS_Near] = { 0.f, 1.f / 30.f, true };
+	Settings[(int32)EShooterSignificance::ESS_Far] = { 1.f / 15.f, 1.f / 15.f, true };
+	Settings[(int32)EShooterSignificance::ESS_Hidden] = { 0.25f, 0.1f, true };
+}
+
+void UShooterSignificanceManager::RegisterCharacter(AShooterCharacter* Character)
+{
+	if (Character == nullptr) return;
+
+	// Higher is more significant, the manager keeps the best value over all viewpoints
+	auto Significance = [this](FManagedObjectInfo* ObjectInfo, const FTransform& Viewpoint) -> float
+	{
+		const AShooterCharacter* Character = CastChecked<AShooterCharacter>(ObjectInfo->GetObject());
+		return (float)((int32)EShooterSignificance::ESS_MAX - 1 - (int32)GetCharacterSignificance(Character, Viewpoint));
+	};
+
+	auto PostSignificance = [this](FManagedObjectInfo* ObjectInfo, float OldSignificance, float NewSignificance, bool bFinal)
+	{
+		AShooterCharacter* Character = CastChecked<AShooterCharacter>(ObjectInfo->GetObject());
+
+		// Unregistered, back to full rate
+		if (bFinal)
+		{
+			ApplyCharacterSignificance(Character, EShooterSignificance::ESS_Full);
+			return;
+		}
+
+		// Against the last bucket applied, not OldSignificance: a new object starts at a default
+		// significance that may match its first bucket, which then would never be applied
+		const EShooterSignificance Bucket{
+			(EShooterSignificance)((int32)EShooterSignificance::ESS_MAX - 1 - FMath::RoundToInt(NewSignificance)) };
+		const EShooterSignificance* AppliedBucket = AppliedSignificance.Find(Character);
+		if (AppliedBucket == nullptr || *AppliedBucket != Bucket)
+		{
+			ApplyCharacterSignificance(Character, Bucket);
+		}
+	};
+
+	RegisterObject(Character, CharacterTag, Significance, EPostSignificanceType::Sequential, PostSignificance);
+}
+
+void UShooterSignificanceManager::UnregisterCharacter(AShooterCharacter* Character)
+{
+	if (Character == nullptr) return;
+
+	UnregisterObject(Character);
+	AppliedSignificance.Remove(Character);
+}
+
+EShooterSignificance UShooterSignificanceManager::GetCharacterSignificance(const AShooterCharacter* Character, const FTransform& Viewpoint) const
+{
+	if (Character->IsLocallyControlled()) return EShooterSignificance::ESS_Full;
+
+	const float DistanceSquared = FVector::DistSquared(Character->GetActorLocation(), Viewpoint.GetLocation());
+	const bool bNear = DistanceSquared < FMath::Square(NearDistance);
+
+	if (Character->WasRecentlyRendered(VisibilityTimeout))
+	{
+		if (bNear) return EShooterSignificance::ESS_Full;
+		return DistanceSquared < FMath::Square(FarDistance) ? EShooterSignificance::ESS_Near : EShooterSignificance::ESS_Far;
+	}
+
+	return bNear ? EShooterSignificance::ESS_Far : EShooterSignificance::ESS_Hidden;
+}
+
+void UShooterSignificanceManager::ApplyCharacterSignificance(AShooterCharacter* Character, EShooterSignificance Significance)
+{
+	AppliedSignificance.Add(Character, Significance);
+
+	const FShooterSignificanceSettings& Setting = Settings[(int32)Significance];
+
+	Character->SetActorTickInterval(Setting.TickInterval);
+
+	if (USkeletalMeshComponent* Mesh = Character->GetMesh())
+	{
+		Mesh->SetComponentTickInterval(Setting.AnimTickInterval);
+		Mesh->bEnableUpdateRateOptimizations = Setting.bUpdateRateOptimizations;
+	}
+}
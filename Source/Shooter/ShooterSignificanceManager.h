@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SignificanceManager.h"
+#include "ShooterSignificanceManager.generated.h"
+
+class AShooterCharacter;
+
+enum class EShooterSignificance : uint8
+{
+	/** Locally controlled, or visible and close */
+	ESS_Full,
+	/** Visible, mid range */
+	ESS_Near,
+	/** Visible and far, or hidden and close */
+	ESS_Far,
+	/** Hidden and not close */
+	ESS_Hidden,
+
+	ESS_MAX
+};
+
+/** How often a character in one significance bucket ticks and animates */
+struct FShooterSignificanceSettings
+{
+	/** Actor tick interval, 0 for every frame */
+	float TickInterval;
+
+	/** Mesh tick interval, anim update and evaluation run when the mesh ticks */
+	float AnimTickInterval;
+
+	/** Lets URO skip / interpolate evaluations on top of the mesh tick interval */
+	bool bUpdateRateOptimizations;
+};
+
+/**
+ * Buckets every remote character by distance and visibility to the local viewer and scales its
+ * actor tick, anim tick and URO accordingly. Updated by AShooterPlayerController::PlayerTick.
+ * Set as the project's SignificanceManagerClassName in DefaultEngine.ini.
+ */
+UCLASS()
+class SHOOTER_API UShooterSignificanceManager : public USignificanceManager
+{
+	GENERATED_BODY()
+
+public:
+	UShooterSignificanceManager();
+
+	static const FName CharacterTag;
+
+	/** Characters on clients and in standalone, the server always runs them at full rate */
+	void RegisterCharacter(AShooterCharacter* Character);
+	void UnregisterCharacter(AShooterCharacter* Character);
+
+private:
+	EShooterSignificance GetCharacterSignificance(const AShooterCharacter* Character, const FTransform& Viewpoint) const;
+
+	void ApplyCharacterSignificance(AShooterCharacter* Character, EShooterSignificance Significance);
+
+	/** Bucket last applied to each registered character */
+	TMap<const AShooterCharacter*, EShooterSignificance> AppliedSignificance;
+
+	/** Visible characters closer than this are ESS_Full, hidden ones ESS_Far */
+	UPROPERTY(EditAnywhere, Config, Category = Significance)
+	float NearDistance;
+
+	/** Visible characters closer than this are ESS_Near */
+	UPROPERTY(EditAnywhere, Config, Category = Significance)
+	float FarDistance;
+
+	/** Seconds since last rendered for a character to count as hidden */
+	UPROPERTY(EditAnywhere, Config, Category = Significance)
+	float VisibilityTimeout;
+
+	/** Indexed by EShooterSignificance */
+	FShooterSignificanceSettings Settings[(int32)EShooterSignificance::ESS_MAX];
+};
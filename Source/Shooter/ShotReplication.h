@@ -0,0 +1,178 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "Engine/NetSerialization.h"
+#include "ShotReplication.generated.h"
+
+/** One shot fired by a client, validated and traced by the server */
+USTRUCT()
+struct FShotRequest
+{
+	GENERATED_BODY()
+
+	/** Where the client's crosshair trace started, its camera */
+	UPROPERTY()
+	FVector_NetQuantize TraceStart;
+
+	/** Crosshair direction, the pellet cone is built around it */
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction;
+
+	/** Seeds the pellet cone so client and server generate the same pellets */
+	UPROPERTY()
+	uint16 Seed = 0;
+
+	/** Crosshair spread multiplier, see QuantizeSpread */
+	UPROPERTY()
+	uint8 Spread = 0;
+
+	/** Orders the shot among the client's predicted actions, acknowledged by ClientAckShots */
+	UPROPERTY()
+	uint16 Sequence = 0;
+
+	/** Server world time on the client when the shot was fired */
+	UPROPERTY()
+	float ClientTime = 0.f;
+
+	/** Spread multiplier in steps of 1/32, up to ~8 */
+	static uint8 QuantizeSpread(float SpreadMultiplier)
+	{
+		return (uint8)FMath::Clamp(FMath::RoundToInt(SpreadMultiplier * 32.f), 0, 255);
+	}
+
+	static float DequantizeSpread(uint8 QuantizedSpread)
+	{
+		return QuantizedSpread / 32.f;
+	}
+
+	FORCEINLINE float GetSpreadMultiplier() const { return DequantizeSpread(Spread); }
+
+	/** Fields back to back without per-property headers, ShooterBenchmarkShotBandwidth logs the size */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		bool bTraceStartSuccess = true;
+		bool bDirectionSuccess = true;
+		TraceStart.NetSerialize(Ar, Map, bTraceStartSuccess);
+		Direction.NetSerialize(Ar, Map, bDirectionSuccess);
+		Ar << Seed;
+		Ar << Spread;
+		Ar << Sequence;
+		Ar << ClientTime;
+
+		bOutSuccess = bTraceStartSuccess && bDirectionSuccess;
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FShotRequest> : public TStructOpsTypeTraitsBase2<FShotRequest>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/** Where a shot (or a group of pellets) landed, for cosmetics on other clients */
+USTRUCT()
+struct FShotImpact
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	UPROPERTY()
+	bool bBlockingHit = false;
+};
+
+/** Cosmetic results of every shot the server resolved during one net update */
+USTRUCT()
+struct FShotCosmeticBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FShotImpact> Impacts;
+
+	UPROPERTY()
+	uint8 ShotCount = 0;
+};
+
+/** True if sequence A was issued after B, survives the uint16 wrap */
+FORCEINLINE bool IsNewerShotSequence(uint16 A, uint16 B)
+{
+	return (int16)(A - B) > 0;
+}
+
+/** A shot or reload the owning client applied before the server acknowledged it */
+struct FPredictedShotAction
+{
+	uint16 Sequence = 0;
+
+	/** Magazine right after a predicted reload, INDEX_NONE for a shot */
+	int32 ReloadedAmmo = INDEX_NONE;
+};
+
+/**
+ * Fixed ring of the client's un-acknowledged actions. Never allocates; when full the client
+ * stops predicting until the server catches up.
+ */
+struct FShotPredictionBuffer
+{
+	static constexpr int32 Capacity = 32;
+
+	FORCEINLINE bool IsFull() const { return Num == Capacity; }
+	FORCEINLINE int32 GetNum() const { return Num; }
+
+	/** Issues the next sequence number and records the action under it */
+	uint16 Add(int32 ReloadedAmmo = INDEX_NONE)
+	{
+		check(!IsFull());
+		FPredictedShotAction& Action = Actions[(Head + Num) % Capacity];
+		Action.Sequence = NextSequence++;
+		Action.ReloadedAmmo = ReloadedAmmo;
+		Num++;
+		return Action.Sequence;
+	}
+
+	/** Forgets every action up to and including AckedSequence */
+	void Acknowledge(uint16 AckedSequence)
+	{
+		while (Num > 0 && !IsNewerShotSequence(Actions[Head].Sequence, AckedSequence))
+		{
+			Head = (Head + 1) % Capacity;
+			Num--;
+		}
+	}
+
+	/** Re-applies the pending actions on top of the server's magazine */
+	int32 Replay(int32 AuthoritativeAmmo) const
+	{
+		int32 PredictedAmmo = AuthoritativeAmmo;
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			const FPredictedShotAction& Action = Actions[(Head + Index) % Capacity];
+			PredictedAmmo = Action.ReloadedAmmo != INDEX_NONE ?
+				Action.ReloadedAmmo :
+				FMath::Max(PredictedAmmo - 1, 0);
+		}
+		return PredictedAmmo;
+	}
+
+	/** Drops the pending actions, sequence numbers keep counting */
+	void Reset()
+	{
+		Head = 0;
+		Num = 0;
+	}
+
+private:
+	TStaticArray<FPredictedShotAction, Capacity> Actions;
+	int32 Head = 0;
+	int32 Num = 0;
+	uint16 NextSequence = 1;
+};
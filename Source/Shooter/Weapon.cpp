@@ -2,19 +2,65 @@
 
 
 #include "Weapon.h"
+#include "WeaponDataAsset.h"
+#include "ItemTickSubsystem.h"
+#include "Engine/AssetManager.h"
+#include "Engine/SkeletalMesh.h"
+#include "Particles/ParticleSystem.h"
+#include "Sound/SoundCue.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Kismet/GameplayStatics.h"
 
 AWeapon::AWeapon() :
 	ThrowWeaponTime(3.f),
 	bFalling(false),
+	bKinematicThrow(false),
+	MaxSimulatedThrows(16),
+	SettleSpeed(5.f),
+	SettleTime(0.1f),
+	KinematicThrowSpeed(400.f),
+	bKinematicFall(false),
+	FallTime(0.f),
+	SlowTime(0.f),
+	ThrowArcIndex(0),
+	WeaponData(nullptr),
 	Ammo(0)
 {
-	// Actor can tick
-	PrimaryActorTick.bCanEverTick = true;
 }
 
-void AWeapon::Tick(float DeltaTime)
+void AWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
-	Super::Tick(DeltaTime);
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.Condition = COND_SkipOwner;
+
+	// The owner predicts it and is corrected through AShooterCharacter::ClientAckShots
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, Ammo, Params);
+
+	Params.Condition = COND_None;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, bKinematicFall, Params);
+}
+
+void AWeapon::BeginPlay()
+{
+	Super::BeginPlay();
+
+	ApplyWeaponDataMesh();
+}
+
+void AWeapon::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	EndThrow();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AWeapon::TickItem(float DeltaTime)
+{
+	Super::TickItem(DeltaTime);
 
 	// Keep the Weapon upright
 	/*if (GetItemState() == EItemState::EIS_Falling && bFalling)
@@ -22,6 +68,39 @@ void AWeapon::Tick(float DeltaTime)
 		const FRotator MeshRotation{ 0.f, GetItemMesh()->GetComponentRotation().Yaw, 0.f };
 		GetItemMesh()->SetWorldRotation(MeshRotation, false, nullptr, ETeleportType::TeleportPhysics);
 	}*/
+
+	// The thrower decides when the weapon rests, clients follow ItemState
+	if (!bFalling || GetItemState() != EItemState::EIS_Falling) return;
+
+	FallTime += DeltaTime;
+	if (bKinematicFall)
+	{
+		TickKinematicFall(DeltaTime);
+	}
+	else
+	{
+		TickSimulatedFall(DeltaTime);
+	}
+}
+
+bool AWeapon::ShouldSimulateFalling() const
+{
+	return !bKinematicFall;
+}
+
+void AWeapon::SerializeProxyState(FArchive& Ar)
+{
+	Super::SerializeProxyState(Ar);
+
+	Ar << Ammo;
+
+	// May be set per placed weapon rather than on the class
+	UObject* Data = WeaponData;
+	Ar << Data;
+	if (Ar.IsLoading())
+	{
+		WeaponData = Cast<UWeaponDataAsset>(Data);
+	}
 }
 
 void AWeapon::ThrowWeapon()
@@ -39,10 +118,37 @@ void AWeapon::ThrowWeapon()
 	float RandomRotation{ FMath::FRandRange(-10, 10)};
 	throwDirection = throwDirection.RotateAngleAxis(RandomRotation, 
 		FVector(0.f, 0.f, 1.f));
-	throwDirection *= 10'000.f;
-	GetItemMesh()->AddImpulse(throwDirection);
+
+	// A throw still in progress, e.g. picked up mid air and dropped again
+	EndThrow();
+
+	// Mass drops (deaths in a big fight) turn into arcs rather than piling up rigid bodies.
+	// Counted per world, PIE clients and a listen server each have their own physics scene
+	UItemTickSubsystem* TickSubsystem = GetWorld()->GetSubsystem<UItemTickSubsystem>();
+	bKinematicFall = bKinematicThrow || TickSubsystem == nullptr
+		|| TickSubsystem->GetNumSimulatedThrows() >= MaxSimulatedThrows;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, bKinematicFall, this);
+	SetItemState(EItemState::EIS_Falling);
 
 	bFalling = true;
+	FallTime = 0.f;
+	SlowTime = 0.f;
+
+	if (bKinematicFall)
+	{
+		if (!ComputeThrowArc(throwDirection * KinematicThrowSpeed))
+		{
+			StopFalling();
+			return;
+		}
+	}
+	else
+	{
+		TickSubsystem->AddSimulatedThrow();
+		GetItemMesh()->AddImpulse(throwDirection * 10'000.f);
+	}
+
+	// Upper bound, the weapon normally rests much sooner
 	GetWorldTimerManager().SetTimer(
 		ThrowWeaponTimer, 
 		this, 
@@ -52,10 +158,183 @@ void AWeapon::ThrowWeapon()
 
 void AWeapon::StopFalling()
 {
+	if (!bFalling) return;
+
+	EndThrow();
+
+	// Not if it was picked up on the way
+	if (GetItemState() == EItemState::EIS_Falling)
+	{
+		SetItemState(EItemState::EIS_Idle);
+	}
+}
+
+void AWeapon::EndThrow()
+{
+	if (!bFalling) return;
+
+	if (!bKinematicFall)
+	{
+		if (UItemTickSubsystem* TickSubsystem = GetWorld()->GetSubsystem<UItemTickSubsystem>())
+		{
+			TickSubsystem->RemoveSimulatedThrow();
+		}
+	}
 	bFalling = false;
-	SetItemState(EItemState::EIS_Idle);
+	ThrowArc.Reset();
+	GetWorldTimerManager().ClearTimer(ThrowWeaponTimer);
+}
+
+void AWeapon::TickSimulatedFall(float DeltaTime)
+{
+	// The impulse lands on the next physics step, don't judge the first frames
+	if (FallTime < SettleTime) return;
+
+	UPrimitiveComponent* Mesh = GetItemMesh();
+
+	// The solver put it to sleep
+	if (!Mesh->RigidBodyIsAwake())
+	{
+		StopFalling();
+		return;
+	}
+
+	// Slow for a while rather than for one frame, the top of a bounce is slow too
+	SlowTime = Mesh->GetPhysicsLinearVelocity().SizeSquared() < FMath::Square(SettleSpeed) ?
+		SlowTime + DeltaTime :
+		0.f;
+	if (SlowTime >= SettleTime)
+	{
+		StopFalling();
+	}
+}
+
+void AWeapon::TickKinematicFall(float DeltaTime)
+{
+	while (ThrowArcIndex + 1 < ThrowArc.Num() && ThrowArc[ThrowArcIndex + 1].Time <= FallTime)
+	{
+		ThrowArcIndex++;
+	}
+
+	// Landed
+	if (ThrowArcIndex + 1 >= ThrowArc.Num())
+	{
+		SetActorLocation(ThrowArc.Last().Location);
+		StopFalling();
+		return;
+	}
+
+	const FPredictProjectilePathPointData& From = ThrowArc[ThrowArcIndex];
+	const FPredictProjectilePathPointData& To = ThrowArc[ThrowArcIndex + 1];
+	const float Alpha{ (FallTime - From.Time) / FMath::Max(To.Time - From.Time, KINDA_SMALL_NUMBER) };
+	SetActorLocation(FMath::Lerp(From.Location, To.Location, Alpha));
+}
+
+bool AWeapon::ComputeThrowArc(const FVector& LaunchVelocity)
+{
+	// Coarse steps, a handful of sweeps against static geometry for the whole arc
+	FPredictProjectilePathParams PathParams(
+		10.f,
+		GetActorLocation(),
+		LaunchVelocity,
+		ThrowWeaponTime,
+		ECollisionChannel::ECC_WorldStatic,
+		this);
+	PathParams.SimFrequency = 10.f;
+	PathParams.ActorsToIgnore.Add(GetOwner());
+
+	FPredictProjectilePathResult PathResult;
+	UGameplayStatics::PredictProjectilePath(this, PathParams, PathResult);
+
+	ThrowArc = MoveTemp(PathResult.PathData);
+	ThrowArcIndex = 0;
+	return ThrowArc.Num() > 0;
+}
+
+#pragma region Definition
+void AWeapon::SetWeaponData(UWeaponDataAsset* Data)
+{
+	WeaponData = Data;
+	ApplyWeaponDataMesh();
+}
+
+void AWeapon::ApplyWeaponDataMesh()
+{
+	if (WeaponData == nullptr || WeaponData->Mesh.IsNull()) return;
+
+	if (USkeletalMesh* Mesh = WeaponData->Mesh.Get())
+	{
+		GetItemMesh()->SetSkeletalMesh(Mesh);
+		return;
+	}
+
+	// Not preloaded, stream it in instead of blocking
+	UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		WeaponData->Mesh.ToSoftObjectPath(),
+		FStreamableDelegate::CreateUObject(this, &AWeapon::ApplyWeaponDataMesh));
+}
+
+USoundCue* AWeapon::GetFireSound() const
+{
+	return WeaponData ? WeaponData->FireSound.Get() : nullptr;
+}
+
+UParticleSystem* AWeapon::GetMuzzleFlash() const
+{
+	return WeaponData ? WeaponData->MuzzleFlash.Get() : nullptr;
+}
+
+UParticleSystem* AWeapon::GetImpactParticles() const
+{
+	return WeaponData ? WeaponData->ImpactParticles.Get() : nullptr;
+}
+
+UParticleSystem* AWeapon::GetBeamParticles() const
+{
+	return WeaponData ? WeaponData->BeamParticles.Get() : nullptr;
 }
 
+const UWeaponDataAsset* AWeapon::GetWeaponDataOrDefault() const
+{
+	return WeaponData ? WeaponData : GetDefault<UWeaponDataAsset>();
+}
+
+EWeaponType AWeapon::GetWeaponType() const
+{
+	return GetWeaponDataOrDefault()->WeaponType;
+}
+
+EMyAmmoType AWeapon::GetAmmoType() const
+{
+	return GetWeaponDataOrDefault()->AmmoType;
+}
+
+FName AWeapon::GetReloadMontageSection() const
+{
+	return GetWeaponDataOrDefault()->ReloadMontageSection;
+}
+
+int32 AWeapon::GetMagazineCapacity() const
+{
+	return GetWeaponDataOrDefault()->MagazineCapacity;
+}
+
+FName AWeapon::GetClipBoneName() const
+{
+	return GetWeaponDataOrDefault()->ClipBoneName;
+}
+
+int32 AWeapon::GetPelletCount() const
+{
+	return GetWeaponDataOrDefault()->PelletCount;
+}
+
+float AWeapon::GetPelletSpreadAngle() const
+{
+	return GetWeaponDataOrDefault()->PelletSpreadAngle;
+}
+#pragma endregion
+
 #pragma region Ammo
 void AWeapon::DecrementAmmo()
 {
@@ -67,12 +346,31 @@ void AWeapon::DecrementAmmo()
 	{
 		Ammo = 0;
 	}
+	MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, Ammo, this);
+	OnAmmoChanged.Broadcast(this);
+}
+
+void AWeapon::SetAmmo(int32 NewAmmo)
+{
+	NewAmmo = FMath::Clamp(NewAmmo, 0, GetMagazineCapacity());
+	if (NewAmmo == Ammo) return;
+
+	Ammo = NewAmmo;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, Ammo, this);
+	OnAmmoChanged.Broadcast(this);
 }
 
 void AWeapon::ReloadAmmo(int32 Amount)
 {
-	checkf(Ammo + Amount <= MagazineCapacity,
+	checkf(Ammo + Amount <= GetMagazineCapacity(),
 		TEXT("Attempted to reload with more than magazine capacity!"));
 	Ammo += Amount;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, Ammo, this);
+	OnAmmoChanged.Broadcast(this);
+}
+
+void AWeapon::OnRep_Ammo()
+{
+	OnAmmoChanged.Broadcast(this);
 }
 #pragma endregion
@@ -5,8 +5,14 @@
 #include "CoreMinimal.h"
 #include "Item.h"
 #include "MyAmmoType.h"
+#include "Kismet/GameplayStaticsTypes.h"
 #include "Weapon.generated.h"
 
+class UWeaponDataAsset;
+class UParticleSystem;
+class USoundCue;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnWeaponAmmoChanged, AWeapon* /*Weapon*/);
 
 UENUM(BlueprintType)
 enum class EWeaponType : uint8
@@ -14,6 +20,7 @@ enum class EWeaponType : uint8
 	EWT_SubmachineGun UMETA(DisplayName = "SubmachineGun"),
 	EWT_AssaultRifle UMETA(DisplayName = "AssaultRifle"),
 	EWT_Pistol UMETA(DisplayName = "Pistol"),
+	EWT_Shotgun UMETA(DisplayName = "Shotgun"),
 
 	EWT_MAX UMETA(DisplayName = "DefaultMAX")
 };
@@ -28,59 +35,129 @@ class SHOOTER_API AWeapon : public AItem
 public:
 	AWeapon();
 
-	virtual void Tick(float DeltaTime) override;
+	virtual void TickItem(float DeltaTime) override;
+	virtual void SerializeProxyState(FArchive& Ar) override;
+	virtual bool ShouldSimulateFalling() const override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	void StopFalling();
 private:
 	FTimerHandle ThrowWeaponTimer;
+	/** Longest a throw can last, the weapon rests wherever it is then */
 	float ThrowWeaponTime;
 	bool bFalling;
 
+#pragma region Throw
+	/** Always throw along a precomputed arc instead of simulating */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties|Throw", meta = (AllowPrivateAccess = "true"))
+	bool bKinematicThrow;
+
+	/** Simulated throws allowed at once across all weapons in the world, more become arcs so mass drops don't spike physics */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties|Throw", meta = (AllowPrivateAccess = "true"))
+	int32 MaxSimulatedThrows;
+
+	/** A simulated weapon slower than this (cm/s) for SettleTime seconds is resting */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties|Throw", meta = (AllowPrivateAccess = "true"))
+	float SettleSpeed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties|Throw", meta = (AllowPrivateAccess = "true"))
+	float SettleTime;
+
+	/** Launch speed of an arc throw (cm/s) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties|Throw", meta = (AllowPrivateAccess = "true"))
+	float KinematicThrowSpeed;
+
+	/** The current throw follows ThrowArc, replicated so clients don't simulate it either */
+	UPROPERTY(Replicated)
+	bool bKinematicFall;
+
+	/** Seconds since the throw, and spent below SettleSpeed */
+	float FallTime;
+	float SlowTime;
+
+	/** Points of the arc with their time from the throw, the last one is the landing point */
+	TArray<FPredictProjectilePathPointData> ThrowArc;
+	int32 ThrowArcIndex;
+
+	/** Rests once the body sleeps or slows down */
+	void TickSimulatedFall(float DeltaTime);
+
+	/** Moves along ThrowArc and rests at its end */
+	void TickKinematicFall(float DeltaTime);
+
+	/** Sweeps the ballistic path from the current location, false if it has no points */
+	bool ComputeThrowArc(const FVector& LaunchVelocity);
+
+	/** Bookkeeping of a throw that ends, landed or not */
+	void EndThrow();
+#pragma endregion
 
 public:
-	/** Adds an impulse to the Weapon */
+	/** Sets the weapon Falling and throws it, simulated or along an arc */
 	void ThrowWeapon();
 
+#pragma region Definition
+private:
+	/** Shared stats and assets; a weapon without one gets the UWeaponDataAsset defaults */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	UWeaponDataAsset* WeaponData;
+
+	/** WeaponData, or the data asset class defaults */
+	const UWeaponDataAsset* GetWeaponDataOrDefault() const;
+
+	/** Mesh from WeaponData, set once it is loaded */
+	void ApplyWeaponDataMesh();
+
+public:
+	FORCEINLINE UWeaponDataAsset* GetWeaponData() const { return WeaponData; }
+	void SetWeaponData(UWeaponDataAsset* Data);
+
+	/** Loaded FX / sounds of the definition, null if there is none or it is not loaded */
+	USoundCue* GetFireSound() const;
+	UParticleSystem* GetMuzzleFlash() const;
+	UParticleSystem* GetImpactParticles() const;
+	UParticleSystem* GetBeamParticles() const;
+#pragma endregion
 	
 #pragma region Ammo
 private:
-		UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	/** Authoritative on the server, decremented locally by the owner for responsiveness */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, ReplicatedUsing = OnRep_Ammo, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	int32 Ammo;
-		UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
-	int32 MagazineCapacity;
 
-		UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
-	EWeaponType WeaponType;
-
-	/** The type of ammo for this weapon */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
-	EMyAmmoType AmmoType;
-
-	/** FName for the Reload Montage Section */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
-	FName ReloadMontageSection;
+	UFUNCTION()
+	void OnRep_Ammo();
 
 	/** True when moving the clip while reloading */	
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	bool bMovingClip;
 
-	/** Name for the clip bone */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
-	FName ClipBoneName;
-
 public:
 	FORCEINLINE int32 GetAmmo() const { return Ammo; }
 	void DecrementAmmo();
 
-	FORCEINLINE EWeaponType GetWeaponType() const { return WeaponType; }
-	FORCEINLINE EMyAmmoType GetAmmoType() const { return AmmoType; }
-	FORCEINLINE FName GetReloadMontageSection() const { return ReloadMontageSection; }
+	/** Owning client only, replaces its predicted magazine with the reconciled one */
+	void SetAmmo(int32 NewAmmo);
 
-	FORCEINLINE int32 GetMagazineCapacity() const { return MagazineCapacity; }
+	/** Broadcast when Ammo changes (fire, reload) */
+	FOnWeaponAmmoChanged OnAmmoChanged;
+
+	/** Stats of WeaponData */
+	EWeaponType GetWeaponType() const;
+	EMyAmmoType GetAmmoType() const;
+	FName GetReloadMontageSection() const;
+
+	int32 GetMagazineCapacity() const;
 	void ReloadAmmo(int32 Amount);
 
 	FORCEINLINE void SetMovingClip(bool Move) { bMovingClip = Move; }
-	FORCEINLINE FName GetClipBoneName() const { return ClipBoneName; }
+	FName GetClipBoneName() const;
+
+	int32 GetPelletCount() const;
+	float GetPelletSpreadAngle() const;
 #pragma endregion
 
 };
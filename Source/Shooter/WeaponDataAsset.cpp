@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponDataAsset.h"
+
+UWeaponDataAsset::UWeaponDataAsset() :
+	MagazineCapacity(30),
+	WeaponType(EWeaponType::EWT_SubmachineGun),
+	AmmoType(EMyAmmoType::EAT_9mm),
+	ReloadMontageSection(NAME_None),
+	ClipBoneName(NAME_None),
+	PelletCount(1),
+	PelletSpreadAngle(3.f)
+{
+}
+
+FPrimaryAssetId UWeaponDataAsset::GetPrimaryAssetId() const
+{
+	return FPrimaryAssetId(FPrimaryAssetType("WeaponData"), GetFName());
+}
+
+void UWeaponDataAsset::GetAssetsToLoad(TArray<FSoftObjectPath>& OutAssets) const
+{
+	auto AddIfSet = [&OutAssets](const FSoftObjectPath& Path)
+	{
+		if (Path.IsValid())
+		{
+			OutAssets.AddUnique(Path);
+		}
+	};
+
+	AddIfSet(Mesh.ToSoftObjectPath());
+	AddIfSet(FireSound.ToSoftObjectPath());
+	AddIfSet(MuzzleFlash.ToSoftObjectPath());
+	AddIfSet(ImpactParticles.ToSoftObjectPath());
+	AddIfSet(BeamParticles.ToSoftObjectPath());
+}
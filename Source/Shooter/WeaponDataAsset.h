@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Weapon.h"
+#include "WeaponDataAsset.generated.h"
+
+class USkeletalMesh;
+class UParticleSystem;
+class USoundCue;
+
+/**
+ * Shared definition of a weapon: stats plus soft references to its mesh, FX and sounds.
+ * Weapon instances point at it instead of carrying their own copy of every field.
+ */
+UCLASS(BlueprintType)
+class SHOOTER_API UWeaponDataAsset : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UWeaponDataAsset();
+
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+
+	/** Soft references that have to be loaded before a weapon using this definition is spawned */
+	void GetAssetsToLoad(TArray<FSoftObjectPath>& OutAssets) const;
+
+#pragma region Stats
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Properties")
+	int32 MagazineCapacity;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Properties")
+	EWeaponType WeaponType;
+
+	/** The type of ammo for this weapon */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Properties")
+	EMyAmmoType AmmoType;
+
+	/** FName for the Reload Montage Section */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Properties")
+	FName ReloadMontageSection;
+
+	/** Name for the clip bone */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Properties")
+	FName ClipBoneName;
+
+	/** Rays per shot, more than 1 fires a pellet spread */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Properties", meta = (ClampMin = "1", ClampMax = "32"))
+	int32 PelletCount;
+
+	/** Half angle of the pellet cone in degrees, scaled by the crosshair spread multiplier */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Properties", meta = (ClampMin = "0.0"))
+	float PelletSpreadAngle;
+#pragma endregion
+
+#pragma region Assets
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Assets")
+	TSoftObjectPtr<USkeletalMesh> Mesh;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Assets")
+	TSoftObjectPtr<USoundCue> FireSound;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Assets")
+	TSoftObjectPtr<UParticleSystem> MuzzleFlash;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Assets")
+	TSoftObjectPtr<UParticleSystem> ImpactParticles;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Assets")
+	TSoftObjectPtr<UParticleSystem> BeamParticles;
+#pragma endregion
+};
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponRigCache.h"
+#include "Weapon.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMeshSocket.h"
+
+const FName FWeaponRigCache::BarrelSocketName(TEXT("BarrelSocket"));
+const FName FWeaponRigCache::RightHandSocketName(TEXT("RightHandSocket"));
+const FName FWeaponRigCache::LeftHandBoneName(TEXT("Hand_L"));
+
+void FWeaponRigCache::Build(USkeletalMeshComponent* CharacterMesh, AWeapon* Weapon)
+{
+	Reset();
+
+	if (CharacterMesh)
+	{
+		RightHandSocket = CharacterMesh->GetSocketByName(RightHandSocketName);
+	}
+
+	if (Weapon == nullptr || Weapon->GetItemMesh() == nullptr) return;
+
+	USkeletalMeshComponent* Mesh = Weapon->GetItemMesh();
+	WeaponMesh = Mesh;
+	WeaponMeshAsset = Mesh->SkeletalMesh;
+
+	if (const USkeletalMeshSocket* BarrelSocket = Mesh->GetSocketByName(BarrelSocketName))
+	{
+		bHasBarrelSocket = true;
+		BarrelBoneIndex = Mesh->GetBoneIndex(BarrelSocket->BoneName);
+		BarrelSocketLocalTransform = BarrelSocket->GetSocketLocalTransform();
+	}
+
+	ClipBoneIndex = Mesh->GetBoneIndex(Weapon->GetClipBoneName());
+}
+
+void FWeaponRigCache::Reset()
+{
+	*this = FWeaponRigCache();
+}
+
+bool FWeaponRigCache::IsValidFor(const AWeapon* Weapon) const
+{
+	return Weapon &&
+		WeaponMesh.Get() == Weapon->GetItemMesh() &&
+		WeaponMeshAsset.Get() == Weapon->GetItemMesh()->SkeletalMesh;
+}
+
+bool FWeaponRigCache::GetBarrelTransform(FTransform& OutTransform) const
+{
+	const USkeletalMeshComponent* Mesh = WeaponMesh.Get();
+	if (Mesh == nullptr || !bHasBarrelSocket) return false;
+
+	// Same as USkeletalMeshSocket::GetSocketTransform, without the bone name lookup
+	OutTransform = BarrelSocketLocalTransform * (BarrelBoneIndex != INDEX_NONE ?
+		Mesh->GetBoneTransform(BarrelBoneIndex) :
+		Mesh->GetComponentTransform());
+	return true;
+}
@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AWeapon;
+class USkeletalMesh;
+class USkeletalMeshComponent;
+class USkeletalMeshSocket;
+
+/**
+ * Sockets and bone indices the fire and reload paths need, resolved once when a weapon is equipped
+ * so those paths never look anything up by name.
+ */
+struct SHOOTER_API FWeaponRigCache
+{
+	static const FName BarrelSocketName;
+	static const FName RightHandSocketName;
+	static const FName LeftHandBoneName;
+
+	/** Resolves every socket and bone of CharacterMesh and Weapon */
+	void Build(USkeletalMeshComponent* CharacterMesh, AWeapon* Weapon);
+
+	/** Called on drop / swap */
+	void Reset();
+
+	/** True if built for Weapon and its mesh asset has not changed since */
+	bool IsValidFor(const AWeapon* Weapon) const;
+
+	/** World transform of the barrel socket, false if the weapon has none */
+	bool GetBarrelTransform(FTransform& OutTransform) const;
+
+	const USkeletalMeshSocket* RightHandSocket = nullptr;
+	int32 ClipBoneIndex = INDEX_NONE;
+
+private:
+	TWeakObjectPtr<USkeletalMeshComponent> WeaponMesh;
+	TWeakObjectPtr<USkeletalMesh> WeaponMeshAsset;
+
+	bool bHasBarrelSocket = false;
+	int32 BarrelBoneIndex = INDEX_NONE;
+	FTransform BarrelSocketLocalTransform;
+};